@@ -0,0 +1,280 @@
+#include <Tetris/HeadlessTetris.h>
+#include <Tetris/ImageWriter.h>
+#include <Tetris/Perft.h>
+#include <Tetris/PollingTimer.h>
+#include <Tetris/SpectatorStream.h>
+#include <Tetris/TimerWheel.h>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+
+//! compare the engine calling its collaborators through interfaces
+//! with the same engine on final collaborators (HeadlessTetris),
+//! then the cost of a loop iteration of a server ticking many games
+//! and the bandwidth of a spectator stream, then the perft speed
+//! usage: bench_tetris [nb_moves]
+
+using namespace tetris;
+
+namespace {
+
+//! plays games with a pseudo random player until @param nb_moves inputs are sent
+//!@return mean time of an input, in nanoseconds
+template <class Engine>
+double NanosecondsPerMove(int nb_moves, int64_t& checksum) {
+  uint32_t rng = 1;
+  int seed = 0;
+  int done = 0;
+
+  const auto begin = std::chrono::steady_clock::now();
+  while (done < nb_moves) {
+    UserInput user_input;
+    VirtualTimer timer;
+    NintendoClassicScore score;
+    TetriminosGenerator gen(seed++);
+    Engine game(user_input, timer, score, gen, 3);
+    InputListener& input = game;
+    input.OnResume();
+
+    for (; done < nb_moves && !game.IsOver(); done++) {
+      rng = rng * 1664525u + 1013904223u;
+      switch (rng >> 30) {
+        case 0:
+          input.OnLeft();
+          break;
+        case 1:
+          input.OnRight();
+          break;
+        case 2:
+          input.OnRotate();
+          break;
+        default:
+          input.OnFastDown();
+      }
+    }
+    checksum += score.Score();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+
+  return std::chrono::duration<double, std::nano>(elapsed).count() / nb_moves;
+}
+
+struct EventCounter : TimerListener {
+  void OnTimerEvent(const ITimer&) override { count++; }
+  int64_t count{};
+};
+
+constexpr int kNbTimers = 10000;
+
+//!@return mean time of a loop iteration polling @param nb_timers timers, in nanoseconds
+double NanosecondsPerPollingSpin(int nb_spins, int64_t& checksum) {
+  EventCounter counter;
+  std::vector<PollingTimer> timers(kNbTimers);
+  for (int i = 0; i < kNbTimers; i++) {
+    timers[i].Register(&counter);
+    timers[i].Start(std::chrono::milliseconds{100 + i % 900});
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (int spin = 0; spin < nb_spins; spin++) {
+    for (auto& timer : timers)
+      timer.Poll();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  checksum += counter.count;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / nb_spins;
+}
+
+//!@return mean time of a loop iteration advancing a wheel of @param nb_timers timers by 1ms
+double NanosecondsPerWheelSpin(int nb_spins, int64_t& checksum) {
+  EventCounter counter;
+  TimerWheel wheel;
+  std::vector<std::unique_ptr<WheelTimer>> timers;
+  for (int i = 0; i < kNbTimers; i++) {
+    timers.push_back(std::make_unique<WheelTimer>(wheel));
+    timers.back()->Register(&counter);
+    timers.back()->Start(std::chrono::milliseconds{100 + i % 900});
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (int spin = 1; spin <= nb_spins; spin++)
+    wheel.AdvanceTo(std::chrono::milliseconds{spin});
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  checksum += counter.count;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / nb_spins;
+}
+
+//! plays @param nb_games games, an input every 100ms, each event streamed to a spectator
+//!@return mean bytes per second of game
+double SpectatorBytesPerSecond(int nb_games, int64_t& checksum) {
+  uint32_t rng = 1;
+  int64_t bytes_sent = 0;
+  double seconds = 0;
+  for (int seed = 0; seed < nb_games; seed++) {
+    UserInput user_input;
+    VirtualTimer timer;
+    NintendoClassicScore score;
+    TetriminosGenerator gen(seed);
+    HeadlessTetris game(user_input, timer, score, gen, 3);
+    InputListener& input = game;
+    DeltaEncoder encoder;
+    DeltaDecoder spectator;
+    std::vector<uint8_t> bytes;
+    const auto stream = [&] {
+      bytes.clear();
+      encoder.Encode(game, bytes);
+      spectator.Decode(bytes);
+      bytes_sent += static_cast<int64_t>(bytes.size());
+    };
+    input.OnResume();
+    stream();
+
+    while (!game.IsOver()) {
+      // gravity events of the next 100ms, one at a time
+      auto left = std::chrono::nanoseconds{std::chrono::milliseconds{100}};
+      while (timer.TimeToNextEvent() <= left) {
+        left -= timer.TimeToNextEvent();
+        timer.AdvanceToNextEvent();
+        stream();
+      }
+      timer.Advance(left);
+      rng = rng * 1664525u + 1013904223u;
+      switch (rng >> 30) {
+        case 0:
+          input.OnLeft();
+          break;
+        case 1:
+          input.OnRight();
+          break;
+        case 2:
+          input.OnRotate();
+          break;
+        default:
+          input.OnHardDrop();
+      }
+      stream();
+    }
+    seconds += std::chrono::duration<double>(timer.Now()).count();
+    checksum += spectator.State().score;
+  }
+  return static_cast<double>(bytes_sent) / seconds;
+}
+
+//! perft of @param depth from seeded positions
+//!@return leaves per second, @param moves_per_second engine moves per second
+double PerftNodesPerSecond(int depth, double& moves_per_second, int64_t& checksum) {
+  uint64_t nodes = 0;
+  uint64_t moves = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (uint32_t seed = 1; seed <= 3; seed++) {
+    Perft perft(seed);
+    nodes += perft.Count(depth);
+    moves += perft.Moves();
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  checksum += static_cast<int64_t>(nodes);
+  moves_per_second = static_cast<double>(moves) / seconds;
+  return static_cast<double>(nodes) / seconds;
+}
+
+//! counts the bytes written, instead of a file
+struct NullBuffer : std::streambuf {
+  std::streamsize xsputn(const char*, std::streamsize n) override {
+    bytes += n;
+    return n;
+  }
+  int overflow(int c) override { return c; }
+  int64_t bytes{};
+};
+
+//! renders and encodes @param nb_frames frames of games played at random, a frame per input
+//!@return frames per second
+double ImageFramesPerSecond(int nb_frames,
+                            ImageSequenceWriter::eFormat format,
+                            int64_t& checksum) {
+  Rasterizer rasterizer(Board::DefaultSize(), 3);
+  NullBuffer buffer;
+  std::ostream out(&buffer);
+  ImageSequenceWriter writer(out, format);
+
+  uint32_t rng = 1;
+  int frames = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int seed = 0; frames < nb_frames; seed++) {
+    UserInput user_input;
+    VirtualTimer timer;
+    NintendoClassicScore score;
+    TetriminosGenerator gen(seed);
+    HeadlessTetris game(user_input, timer, score, gen, 3);
+    InputListener& input = game;
+    input.OnResume();
+    for (; frames < nb_frames && !game.IsOver(); frames++) {
+      rng = rng * 1664525u + 1013904223u;
+      switch (rng >> 30) {
+        case 0:
+          input.OnLeft();
+          break;
+        case 1:
+          input.OnRight();
+          break;
+        case 2:
+          input.OnRotate();
+          break;
+        default:
+          input.OnHardDrop();
+      }
+      rasterizer.Render(game);
+      writer.Write(rasterizer);
+    }
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  checksum += buffer.bytes;
+  return nb_frames / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int nb_moves = argc > 1 ? std::atoi(argv[1]) : 5000000;
+  int64_t checksum = 0;
+
+  NanosecondsPerMove<Tetris>(nb_moves / 10, checksum);  // warm up
+  const double virtual_calls = NanosecondsPerMove<Tetris>(nb_moves, checksum);
+  const double inlined_calls = NanosecondsPerMove<HeadlessTetris>(nb_moves, checksum);
+
+  std::printf("moves: %d (checksum %lld)\n", nb_moves, static_cast<long long>(checksum));
+  std::printf("Tetris         %8.2f ns/move\n", virtual_calls);
+  std::printf("HeadlessTetris %8.2f ns/move\n", inlined_calls);
+
+  const int nb_spins = 1000;
+  const double polling = NanosecondsPerPollingSpin(nb_spins, checksum);
+  const double wheel = NanosecondsPerWheelSpin(nb_spins * 60, checksum);
+  std::printf("%d timers (checksum %lld)\n", kNbTimers, static_cast<long long>(checksum));
+  std::printf("PollingTimer   %8.0f ns/loop\n", polling);
+  std::printf("TimerWheel     %8.0f ns/loop of 1ms\n", wheel);
+
+  const int nb_games = 100;
+  const double spectator = SpectatorBytesPerSecond(nb_games, checksum);
+  std::printf("%d spectated games (checksum %lld)\n", nb_games, static_cast<long long>(checksum));
+  std::printf("DeltaEncoder   %8.1f bytes/s per game\n", spectator);
+
+  const int perft_depth = 3;
+  double perft_moves = 0;
+  const double perft = PerftNodesPerSecond(perft_depth, perft_moves, checksum);
+  std::printf("perft depth %d (checksum %lld)\n", perft_depth, static_cast<long long>(checksum));
+  std::printf("Perft          %8.0f nodes/s, %.0f moves/s\n", perft, perft_moves);
+
+  const int nb_frames = 2000;
+  const double ppm = ImageFramesPerSecond(nb_frames, ImageSequenceWriter::eFormat::Ppm, checksum);
+  const double png = ImageFramesPerSecond(nb_frames, ImageSequenceWriter::eFormat::Png, checksum);
+  std::printf("%d rendered frames (checksum %lld)\n", nb_frames, static_cast<long long>(checksum));
+  std::printf("Rasterizer PPM %8.0f frames/s\n", ppm);
+  std::printf("Rasterizer PNG %8.0f frames/s\n", png);
+  return 0;
+}
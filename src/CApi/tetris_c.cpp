@@ -0,0 +1,186 @@
+#include "CApi/tetris_c.h"
+#include <new>
+#include <vector>
+#include "Tetris/Observation.h"
+#include "Tetris/TetrisBatch.h"
+
+using tetris::TetrisBatch;
+
+//! a handle is a batch of one game: same rules, no allocation on step
+struct tetris_game {
+  TetrisBatch batch;
+};
+
+//! a batch handle keeps its actions buffer, steps do not allocate
+struct tetris_batch {
+  TetrisBatch batch;
+  std::vector<tetris::eBatchAction> actions;
+};
+
+static_assert(static_cast<int>(tetris::eObservationFormat::Bytes) == TETRIS_OBSERVATION_BYTES);
+static_assert(static_cast<int>(tetris::eObservationFormat::Bits) == TETRIS_OBSERVATION_BITS);
+
+namespace {
+
+bool IsFormat(int format) {
+  return format == TETRIS_OBSERVATION_BYTES || format == TETRIS_OBSERVATION_BITS;
+}
+
+size_t ObservationSize(const TetrisBatch& batch, int format) {
+  return tetris::LayoutOf(batch).Size(static_cast<tetris::eObservationFormat>(format));
+}
+
+void Observe(const TetrisBatch& batch, int format, uint8_t* out) {
+  tetris::WriteObservation(batch, 0, static_cast<tetris::eObservationFormat>(format), out);
+}
+
+bool Step(tetris_game* game, int32_t action, int32_t* reward, int32_t* done) {
+  if (!game || action < 0 || action >= TETRIS_ACTION_COUNT)
+    return false;
+  const auto batch_action = static_cast<tetris::eBatchAction>(action);
+  game->batch.Step(&batch_action);
+  if (reward)
+    *reward = game->batch.Reward(0);
+  if (done)
+    *done = game->batch.IsOver(0);
+  return true;
+}
+
+}  // namespace
+
+extern "C" {
+
+tetris_game* tetris_create(int width, int height, int preview, uint32_t seed) {
+  try {
+    return new tetris_game{TetrisBatch{1, seed, tetris::BoardSize{width, height}, preview}};
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void tetris_destroy(tetris_game* game) {
+  delete game;
+}
+
+void tetris_reset(tetris_game* game, uint32_t seed) {
+  if (game)
+    game->batch.Reset(0, seed);
+}
+
+int tetris_step(tetris_game* game, int action, int32_t* reward, int32_t* done) {
+  return Step(game, action, reward, done) ? 0 : -1;
+}
+
+int tetris_step_batch(tetris_game* const* games,
+                      int nb_games,
+                      const int32_t* actions,
+                      int32_t* rewards,
+                      int32_t* dones,
+                      int format,
+                      uint8_t* observations) {
+  if (nb_games < 0 || (nb_games && (!games || !actions)) || !IsFormat(format))
+    return -1;
+
+  for (int i = 0; i < nb_games; i++) {
+    if (!games[i] || actions[i] < 0 || actions[i] >= TETRIS_ACTION_COUNT)
+      return -1;
+  }
+  const size_t size = nb_games ? ObservationSize(games[0]->batch, format) : 0;
+  for (int i = 0; i < nb_games && observations; i++) {
+    if (ObservationSize(games[i]->batch, format) != size)
+      return -1;
+  }
+
+  for (int i = 0; i < nb_games; i++) {
+    if (!Step(games[i], actions[i], rewards ? rewards + i : nullptr, dones ? dones + i : nullptr))
+      return -1;
+    if (observations)
+      Observe(games[i]->batch, format, observations + i * size);
+  }
+  return 0;
+}
+
+tetris_batch* tetris_batch_create(int nb_games,
+                                  int width,
+                                  int height,
+                                  int preview,
+                                  uint32_t seed) {
+  if (nb_games < 1)
+    return nullptr;
+  try {
+    return new tetris_batch{
+        TetrisBatch{nb_games, seed, tetris::BoardSize{width, height}, preview},
+        std::vector<tetris::eBatchAction>(static_cast<size_t>(nb_games))};
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void tetris_batch_destroy(tetris_batch* batch) {
+  delete batch;
+}
+
+int tetris_batch_size(const tetris_batch* batch) {
+  return batch ? batch->batch.Size() : 0;
+}
+
+int tetris_batch_reset(tetris_batch* batch, int game, uint32_t seed) {
+  if (!batch || game < 0 || game >= batch->batch.Size())
+    return -1;
+  batch->batch.Reset(game, seed);
+  return 0;
+}
+
+int tetris_batch_step(tetris_batch* batch,
+                      const int32_t* actions,
+                      int32_t* rewards,
+                      int32_t* dones,
+                      int format,
+                      uint8_t* observations) {
+  if (!batch || !actions || !IsFormat(format))
+    return -1;
+  const int nb_games = batch->batch.Size();
+  for (int i = 0; i < nb_games; i++) {
+    if (actions[i] < 0 || actions[i] >= TETRIS_ACTION_COUNT)
+      return -1;
+    batch->actions[i] = static_cast<tetris::eBatchAction>(actions[i]);
+  }
+
+  batch->batch.Step(batch->actions.data());
+  const size_t size = ObservationSize(batch->batch, format);
+  for (int i = 0; i < nb_games; i++) {
+    if (rewards)
+      rewards[i] = batch->batch.Reward(i);
+    if (dones)
+      dones[i] = batch->batch.IsOver(i);
+    if (observations)
+      tetris::WriteObservation(batch->batch, i, static_cast<tetris::eObservationFormat>(format),
+                               observations + i * size);
+  }
+  return 0;
+}
+
+size_t tetris_batch_observation_size(const tetris_batch* batch, int format) {
+  return batch && IsFormat(format) ? ObservationSize(batch->batch, format) : 0;
+}
+
+size_t tetris_observation_size(const tetris_game* game, int format) {
+  return game && IsFormat(format) ? ObservationSize(game->batch, format) : 0;
+}
+
+int tetris_observe(const tetris_game* game, int format, uint8_t* observation) {
+  if (!game || !observation || !IsFormat(format))
+    return -1;
+  Observe(game->batch, format, observation);
+  return 0;
+}
+
+int32_t tetris_score(const tetris_game* game) {
+  return game ? game->batch.Score(0) : 0;
+}
+
+int32_t tetris_lines(const tetris_game* game) {
+  return game ? game->batch.Lines(0) : 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,111 @@
+#ifndef TETRIS_C_H
+#define TETRIS_C_H
+/* flat C ABI of the engine, for trainers written in other languages
+ *
+ * a handle is one game, steps never allocate and observations are written
+ * in buffers owned by the caller. Functions returning int give 0 on success
+ * and -1 on invalid arguments, no exception crosses this interface. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(TETRIS_C_BUILD)
+#define TETRIS_API __declspec(dllexport)
+#else
+#define TETRIS_API __declspec(dllimport)
+#endif
+#else
+#define TETRIS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tetris_game tetris_game;
+
+typedef enum tetris_action {
+  TETRIS_ACTION_NONE = 0,
+  TETRIS_ACTION_LEFT,
+  TETRIS_ACTION_RIGHT,
+  TETRIS_ACTION_ROTATE,
+  TETRIS_ACTION_REVERSE_ROTATE,
+  TETRIS_ACTION_SOFT_DROP,
+  TETRIS_ACTION_HARD_DROP,
+  TETRIS_ACTION_COUNT
+} tetris_action;
+
+typedef enum tetris_observation_format {
+  TETRIS_OBSERVATION_BYTES = 0, /* a byte per value */
+  TETRIS_OBSERVATION_BITS,      /* 8 values per byte, first value in the lowest bit */
+} tetris_observation_format;
+
+/* @return NULL if the size is not supported (width in [4,16], height in [4,64], preview > 0) */
+TETRIS_API tetris_game* tetris_create(int width, int height, int preview, uint32_t seed);
+TETRIS_API void tetris_destroy(tetris_game* game);
+/* empty board, null score, tetriminos drawn from @p seed */
+TETRIS_API void tetris_reset(tetris_game* game, uint32_t seed);
+
+/* apply @p action then a gravity step
+ * @param reward score gained, may be NULL
+ * @param done 1 once the game is over, steps do nothing then until a reset, may be NULL */
+TETRIS_API int tetris_step(tetris_game* game, int action, int32_t* reward, int32_t* done);
+
+/* tetris_step on @p nb_games handles, then the observation of each game
+ * @param rewards, dones arrays of nb_games, may be NULL
+ * @param observations nb_games * tetris_observation_size() bytes, may be NULL
+ * all handles must share the same size. Handles are stepped one after the other,
+ * use a tetris_batch to step many games with the batched kernels */
+TETRIS_API int tetris_step_batch(tetris_game* const* games,
+                                 int nb_games,
+                                 const int32_t* actions,
+                                 int32_t* rewards,
+                                 int32_t* dones,
+                                 int format,
+                                 uint8_t* observations);
+
+/* games stepped in lockstep by the struct of arrays engine, the fast path of trainers.
+ * games are indexed from 0 to nb_games - 1 */
+typedef struct tetris_batch tetris_batch;
+
+/* game g draws its tetriminos from a mix of @p seed and g, game 0 as tetris_create(seed)
+ * @return NULL if the size is not supported, see tetris_create, or nb_games < 1 */
+TETRIS_API tetris_batch* tetris_batch_create(int nb_games,
+                                             int width,
+                                             int height,
+                                             int preview,
+                                             uint32_t seed);
+TETRIS_API void tetris_batch_destroy(tetris_batch* batch);
+TETRIS_API int tetris_batch_size(const tetris_batch* batch);
+/* empty board and null score of @p game */
+TETRIS_API int tetris_batch_reset(tetris_batch* batch, int game, uint32_t seed);
+
+/* apply actions[g] to game g then a gravity step, then the observation of each game
+ * @param rewards, dones arrays of tetris_batch_size(), may be NULL
+ * @param observations tetris_batch_size() * tetris_batch_observation_size() bytes, may be NULL */
+TETRIS_API int tetris_batch_step(tetris_batch* batch,
+                                 const int32_t* actions,
+                                 int32_t* rewards,
+                                 int32_t* dones,
+                                 int format,
+                                 uint8_t* observations);
+/* @return size in bytes of the observation of one game, 0 on invalid arguments */
+TETRIS_API size_t tetris_batch_observation_size(const tetris_batch* batch, int format);
+
+/* values of an observation, in order:
+ * height * width occupancy of the stale blocks, row after row,
+ * height * width occupancy of the current tetriminos,
+ * one hot of 7 values for the current tetriminos type then for each previewed one
+ * @return size in bytes, 0 on invalid arguments */
+TETRIS_API size_t tetris_observation_size(const tetris_game* game, int format);
+TETRIS_API int tetris_observe(const tetris_game* game, int format, uint8_t* observation);
+
+TETRIS_API int32_t tetris_score(const tetris_game* game);
+TETRIS_API int32_t tetris_lines(const tetris_game* game);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TETRIS_C_H */
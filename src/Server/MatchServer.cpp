@@ -0,0 +1,339 @@
+#include "MatchServer.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+constexpr size_t kMaxLine = 256;
+
+std::runtime_error SystemError(const std::string& what) {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+int Listen(const MatchServer::Config& config, uint16_t& port) {
+  const bool local = !config.unix_path.empty();
+  const int fd = socket(local ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    throw SystemError("socket");
+
+  int bound = -1;
+  if (local) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (config.unix_path.size() >= sizeof(addr.sun_path)) {
+      close(fd);
+      throw std::runtime_error("unix socket path is too long");
+    }
+    std::strcpy(addr.sun_path, config.unix_path.c_str());
+    unlink(addr.sun_path);
+    bound = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+  } else {
+    const int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config.port);
+    if (inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr) != 1) {
+      close(fd);
+      throw std::runtime_error("invalid host address " + config.host);
+    }
+    bound = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    if (bound == 0 && getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0)
+      port = ntohs(addr.sin_port);
+  }
+
+  if (bound < 0 || listen(fd, SOMAXCONN) < 0) {
+    const auto error = SystemError("listen");
+    close(fd);
+    throw error;
+  }
+  return fd;
+}
+
+bool ToKey(const std::string& command, eInputKey& key) {
+  static const std::array<std::pair<const char*, eInputKey>, 6> keys{{
+      {"LEFT", eInputKey::Left},
+      {"RIGHT", eInputKey::Right},
+      {"ROTATE", eInputKey::Rotate},
+      {"REVERSE", eInputKey::ReverseRotate},
+      {"DOWN", eInputKey::FastDown},
+      {"DROP", eInputKey::HardDrop},
+  }};
+  for (const auto& [name, k] : keys) {
+    if (command == name) {
+      key = k;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+MatchServer::MatchServer(const Config& config_p)
+    : config(config_p), next_seed(config_p.seed), start(std::chrono::steady_clock::now()) {
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd < 0)
+    throw SystemError("epoll_create1");
+  try {
+    listen_fd = Listen(config, port);
+  } catch (...) {
+    close(epoll_fd);
+    throw;
+  }
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = 0;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+}
+
+MatchServer::~MatchServer() {
+  rooms.clear();
+  for (auto& [id, client] : clients)
+    close(client.fd);
+  close(listen_fd);
+  close(epoll_fd);
+  if (!config.unix_path.empty())
+    unlink(config.unix_path.c_str());
+}
+
+void MatchServer::Run() {
+  running = true;
+  while (running)
+    Poll(std::chrono::milliseconds{100});
+}
+
+void MatchServer::Poll(std::chrono::milliseconds timeout) {
+  // sleep until the next game timer at most
+  const auto due = start + wheel.Now() + std::min(wheel.TimeToNextEvent(), timeout);
+  const auto wait = std::max(std::chrono::ceil<std::chrono::milliseconds>(
+                                 due - std::chrono::steady_clock::now()),
+                             std::chrono::milliseconds{0});
+
+  std::array<epoll_event, 64> events;
+  const int nb_events = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()),
+                                   static_cast<int>(std::min(wait, timeout).count()));
+  if (nb_events < 0 && errno != EINTR)
+    throw SystemError("epoll_wait");
+
+  for (int i = 0; i < nb_events; i++) {
+    const int id = static_cast<int>(events[i].data.u64);
+    if (id == 0) {
+      Accept();
+      continue;
+    }
+    auto it = clients.find(id);
+    if (it == clients.end())
+      continue;  // closed by a previous event
+    if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+      Close(id);
+      continue;
+    }
+    if (events[i].events & EPOLLOUT)
+      Flush(it->second);
+    if (events[i].events & EPOLLIN)
+      Read(it->second);
+  }
+
+  wheel.AdvanceTo(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start));
+  UpdateRooms();
+}
+
+void MatchServer::Accept() {
+  for (;;) {
+    const int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+      return;  // EAGAIN, or the peer gave up
+    const int id = next_id++;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = static_cast<uint64_t>(id);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    clients.emplace(id, Client{id, fd});
+  }
+}
+
+void MatchServer::Read(Client& client) {
+  const int id = client.id;
+  std::array<char, 4096> buffer;
+  for (;;) {
+    const ssize_t n = recv(client.fd, buffer.data(), buffer.size(), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+      Close(id);
+      return;
+    }
+    if (n < 0)
+      break;
+    client.in.append(buffer.data(), static_cast<size_t>(n));
+  }
+
+  size_t begin = 0;
+  for (size_t end; (end = client.in.find('\n', begin)) != std::string::npos; begin = end + 1) {
+    std::string line = client.in.substr(begin, end - begin);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    Execute(client, line);
+    if (!clients.count(id))
+      return;  // QUIT
+  }
+  client.in.erase(0, begin);
+  if (client.in.size() > kMaxLine)
+    Close(id);
+}
+
+void MatchServer::Execute(Client& client, const std::string& line) {
+  std::istringstream words(line);
+  std::string command;
+  words >> command;
+
+  eInputKey key;
+  if (ToKey(command, key)) {
+    if (client.room.empty())
+      Send(client.id, "ERROR not in a room");
+    else
+      rooms.at(client.room)->Press(client.id, key);
+  } else if (command == "JOIN") {
+    std::string name;
+    words >> name;
+    Join(client, name);
+  } else if (command == "STATE") {
+    SendState(client);
+  } else if (command == "QUIT") {
+    Close(client.id);
+  } else if (!command.empty()) {
+    Send(client.id, "ERROR unknown command " + command);
+  }
+}
+
+void MatchServer::Join(Client& client, const std::string& name) {
+  if (name.empty() || !client.room.empty()) {
+    Send(client.id, name.empty() ? "ERROR missing room name" : "ERROR already in a room");
+    return;
+  }
+  auto& room = rooms[name];
+  if (!room)
+    room = std::make_unique<Room>(wheel, config.room, next_seed++);
+  if (room->IsStarted()) {
+    Send(client.id, "ERROR room is full");
+    return;
+  }
+
+  client.room = name;
+  room->Join(client.id);
+  if (!room->IsStarted()) {
+    Send(client.id, "WAIT");
+    return;
+  }
+  for (auto& [id, other] : clients) {
+    if (other.room == name)
+      Send(id, "START " + std::to_string(room->Seed()));
+  }
+}
+
+void MatchServer::SendState(Client& client) {
+  if (client.room.empty()) {
+    Send(client.id, "ERROR not in a room");
+    return;
+  }
+  const auto& game = rooms.at(client.room)->Game(client.id);
+  const auto current = game.Current();
+  std::ostringstream state;
+  state << "STATE " << game.Scoring().Score() << ' ' << game.Scoring().CompletedLines() << ' '
+        << current.Type() << ' ' << current.Position().x << ' ' << current.Position().y << ' '
+        << current.Rotation() << std::hex;
+  for (int y = 0; y < game.Height(); y++)
+    state << ' ' << game.Playfield().RowMask(y);
+  Send(client.id, state.str());
+}
+
+void MatchServer::Send(int id, const std::string& line) {
+  auto it = clients.find(id);
+  if (it == clients.end())
+    return;
+  it->second.out += line;
+  it->second.out += '\n';
+  Flush(it->second);
+}
+
+void MatchServer::Flush(Client& client) {
+  while (!client.out.empty()) {
+    const ssize_t n = send(client.fd, client.out.data(), client.out.size(), MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno != EAGAIN && errno != EWOULDBLOCK)
+        client.out.clear();  // the peer is gone, EPOLLHUP closes it
+      break;
+    }
+    client.out.erase(0, static_cast<size_t>(n));
+  }
+
+  // wait for room in the socket buffer only when needed
+  const bool writing = !client.out.empty();
+  if (writing != client.writing) {
+    client.writing = writing;
+    epoll_event event{};
+    event.events = EPOLLIN | (writing ? EPOLLOUT : 0u);
+    event.data.u64 = static_cast<uint64_t>(client.id);
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, client.fd, &event);
+  }
+}
+
+void MatchServer::Close(int id) {
+  auto it = clients.find(id);
+  if (it == clients.end())
+    return;
+  const std::string room = it->second.room;
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+  close(it->second.fd);
+  clients.erase(it);
+  if (!room.empty())
+    rooms.at(room)->Leave(id);
+}
+
+void MatchServer::UpdateRooms() {
+  for (auto it = rooms.begin(); it != rooms.end();) {
+    Room& room = *it->second;
+    for (const RoomEvent& event : room.Update()) {
+      switch (event.type) {
+        case RoomEvent::eType::Garbage:
+          Send(event.client, "GARBAGE " + std::to_string(event.rows));
+          break;
+        case RoomEvent::eType::Over:
+          Send(event.client, "OVER");
+          break;
+        case RoomEvent::eType::Win:
+          Send(event.client, "WIN");
+          break;
+      }
+    }
+
+    if (!room.IsFinished()) {
+      ++it;
+      continue;
+    }
+    // players stay connected and may join another room
+    for (auto& [id, client] : clients) {
+      if (client.room == it->first)
+        client.room.clear();
+    }
+    it = rooms.erase(it);
+  }
+}
+
+}  // namespace tetris
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "Server/Room.h"
+#include "Tetris/TimerWheel.h"
+
+namespace tetris {
+
+//! versus match server: one thread, one epoll loop, every game ticked by a shared timer wheel
+//!
+//! text protocol, one command per line
+//! - client: JOIN <room>, LEFT, RIGHT, ROTATE, REVERSE, DOWN, DROP, STATE, QUIT
+//! - server: WAIT, START <seed>, GARBAGE <rows>, OVER, WIN, ERROR <reason>,
+//!   STATE <score> <lines> <type> <x> <y> <rotation> <row masks, hexadecimal, top to bottom>
+class MatchServer {
+ public:
+  struct Config {
+    //! listen on this unix socket path, tcp when empty
+    std::string unix_path;
+    std::string host{"127.0.0.1"};
+    //! 0 picks a free port, see Port()
+    uint16_t port{};
+    Room::Config room{};
+    //! seed of the first room, next rooms get the following ones
+    uint32_t seed{};
+  };
+
+  explicit MatchServer(const Config& config);
+  ~MatchServer();
+  MatchServer(const MatchServer&) = delete;
+  MatchServer& operator=(const MatchServer&) = delete;
+
+  //! tcp port listened, 0 on unix sockets
+  uint16_t Port() const { return port; }
+
+  //! wait at most @param timeout for the sockets, then run the games up to now
+  void Poll(std::chrono::milliseconds timeout);
+  //! poll until Stop()
+  void Run();
+  void Stop() { running = false; }
+
+  int ClientCount() const { return static_cast<int>(clients.size()); }
+  int RoomCount() const { return static_cast<int>(rooms.size()); }
+
+ private:
+  struct Client {
+    int id{};  //!< fds are reused, ids are not
+    int fd{-1};
+    std::string in{};
+    std::string out{};
+    std::string room{};  //!< empty until JOIN
+    bool writing{false};
+  };
+
+  void Accept();
+  void Read(Client& client);
+  void Execute(Client& client, const std::string& line);
+  void Join(Client& client, const std::string& name);
+  void SendState(Client& client);
+  void Send(int id, const std::string& line);
+  void Flush(Client& client);
+  void Close(int id);
+  void UpdateRooms();
+
+  Config config;
+  int epoll_fd{-1};
+  int listen_fd{-1};
+  uint16_t port{};
+  std::atomic<bool> running{false};  //!< cleared by Stop(), from a signal handler too
+  uint32_t next_seed;
+  int next_id{1};  //!< 0 is the listening socket
+  std::chrono::steady_clock::time_point start;
+  TimerWheel wheel;
+  std::unordered_map<int, Client> clients;  //!< by id
+  std::unordered_map<std::string, std::unique_ptr<Room>> rooms;
+};
+
+}  // namespace tetris
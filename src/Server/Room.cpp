@@ -0,0 +1,137 @@
+#include "Room.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Tetris/TetrisImpl.h"
+
+namespace tetris {
+
+template class BasicTetris<ServerTraits>;
+
+Room::Player::Player(TimerWheel& wheel, const Config& config, uint32_t seed, int client_p)
+    : client(client_p),
+      timer(wheel),
+      generator(static_cast<int>(seed)),
+      game(input, timer, score, generator, config.preview, config.board_size) {}
+
+Room::Room(TimerWheel& wheel_p, const Config& config_p, uint32_t seed_p)
+    : wheel(wheel_p), config(config_p), seed(seed_p), holes(seed_p) {
+  if (config.capacity < 1)
+    throw std::runtime_error("a room needs at least one player");
+}
+
+void Room::Join(int client) {
+  if (IsFull() || started)
+    throw std::runtime_error("room is full");
+  players.push_back(std::make_unique<Player>(wheel, config, seed, client));
+  if (IsFull())
+    Start();
+}
+
+void Room::Start() {
+  started = true;
+  for (auto& player : players)
+    player->input.Press(eInputKey::Resume);
+}
+
+int Room::IndexOf(int client) const {
+  const auto it = std::find_if(players.begin(), players.end(),
+                               [client](const auto& player) { return player->client == client; });
+  if (it == players.end())
+    throw std::runtime_error("client is not in the room");
+  return static_cast<int>(it - players.begin());
+}
+
+void Room::Leave(int client) {
+  const int player = IndexOf(client);
+  if (!started) {
+    players.erase(players.begin() + player);
+    return;
+  }
+  if (players[player]->alive)
+    Lose(player);
+}
+
+bool Room::IsFinished() const {
+  const auto alive = std::count_if(players.begin(), players.end(),
+                                   [](const auto& player) { return player->alive; });
+  return (started && alive <= std::min(1, config.capacity - 1)) || alive == 0;
+}
+
+void Room::Press(int client, eInputKey key) {
+  auto& p = *players[IndexOf(client)];
+  if (!started || !p.alive || key == eInputKey::Pause || key == eInputKey::Resume)
+    return;
+  p.input.Press(key);
+}
+
+void Room::Send(int client, int nb_lines) {
+  Route(IndexOf(client), GarbageOf(nb_lines));
+}
+
+void Room::Route(int player, int rows) {
+  const int target = NextAlive(player);
+  if (rows == 0 || target == player)
+    return;
+  players[target]->pending_garbage += rows;
+  events.push_back(RoomEvent{RoomEvent::eType::Garbage, players[target]->client, rows});
+}
+
+int Room::NextAlive(int player) const {
+  for (int i = 1; i < Size(); i++) {
+    const int next = (player + i) % Size();
+    if (players[next]->alive)
+      return next;
+  }
+  return player;
+}
+
+void Room::Lose(int player) {
+  players[player]->alive = false;
+  players[player]->timer.Stop();
+  events.push_back(RoomEvent{RoomEvent::eType::Over, players[player]->client});
+}
+
+std::vector<RoomEvent> Room::Update() {
+  if (!started)
+    return {};
+
+  for (int i = 0; i < Size(); i++) {
+    auto& p = *players[i];
+    if (!p.alive)
+      continue;
+
+    if (const int garbage = p.game.Statistics().garbage; garbage != p.garbage) {
+      Route(i, garbage - p.garbage);
+      p.garbage = garbage;
+    }
+
+    const auto& history = p.game.History();
+    const bool landed =
+        std::find(history.begin() + p.history, history.end(), eAction::Land) != history.end();
+    p.history = history.size();
+    if (landed && p.pending_garbage) {
+      std::uniform_int_distribution<int> column(0, p.game.Width() - 1);
+      p.game.AddGarbage(p.pending_garbage, column(holes));
+      p.pending_garbage = 0;
+    }
+
+    if (p.game.IsOver())
+      Lose(i);
+  }
+
+  if (IsFinished() && !settled) {
+    settled = true;
+    for (auto& p : players) {
+      if (p->alive && config.capacity > 1) {
+        events.push_back(RoomEvent{RoomEvent::eType::Win, p->client});
+        p->timer.Stop();
+      }
+    }
+  }
+
+  std::vector<RoomEvent> out;
+  out.swap(events);
+  return out;
+}
+
+}  // namespace tetris
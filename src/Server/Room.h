@@ -0,0 +1,123 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Tetris/NintendoClassicScore.h"
+#include "Tetris/Tetris.h"
+#include "Tetris/TimerWheel.h"
+
+namespace tetris {
+
+//! garbage rows sent to the opponent for @param nb_lines cleared at once
+constexpr int GarbageOf(int nb_lines) {
+  return nb_lines >= 4 ? 4 : std::max(nb_lines - 1, 0);
+}
+
+//! stats policy of server games: garbage is due at each clear, however many clears
+//! happen between two room updates
+struct GarbageStats : NoEngineStats {
+  void LinesCleared(int nb_lines) { garbage += GarbageOf(nb_lines); }
+
+  int garbage{};  //!< rows sent since the game started
+};
+
+//! engine of match servers: every game is ticked by a timer wheel shared by the process
+struct ServerTraits : DefaultTraits {
+  using Score = NintendoClassicScore;
+  using Timer = WheelTimer;
+  using Generator = TetriminosGenerator;
+  using Stats = GarbageStats;
+};
+
+using ServerTetris = BasicTetris<ServerTraits>;
+
+extern template class BasicTetris<ServerTraits>;
+
+//! input of a remote player, keys are read from its connection
+struct RemoteInput : UserInput {
+  void Press(eInputKey key) { Fire(key); }
+};
+
+struct RoomEvent {
+  enum class eType {
+    Garbage,  //!< rows received, inserted when the player's tetriminos lands
+    Over,
+    Win,
+  };
+  eType type;
+  int client;
+  int rows{};
+};
+
+//! a versus match: every player gets the same tetriminos sequence, line clears send
+//! garbage to the next player still alive, the last one standing wins
+class Room {
+ public:
+  struct Config {
+    int capacity{2};
+    BoardSize board_size{};
+    int preview{1};
+  };
+
+  Room(TimerWheel& wheel, const Config& config, uint32_t seed);
+
+  //! players are identified by @param client, i.e. their connection
+  void Join(int client);
+  //! a player leaving a running match loses it
+  void Leave(int client);
+  //! games start when the room is full
+  bool IsFull() const { return Size() == config.capacity; }
+  bool IsStarted() const { return started; }
+  //! started and at most one player alive, or nobody left
+  bool IsFinished() const;
+
+  int Size() const { return static_cast<int>(players.size()); }
+  uint32_t Seed() const { return seed; }
+  const ServerTetris& Game(int client) const { return Find(client).game; }
+  int PendingGarbage(int client) const { return Find(client).pending_garbage; }
+
+  //! key pressed by @param client, ignored until the match starts or after the player lost
+  void Press(int client, eInputKey key);
+  //! route the garbage of @param nb_lines cleared by @param client
+  void Send(int client, int nb_lines);
+
+  //! collect line clears, insert garbage of landed players and settle the match,
+  //! to call after inputs and timer events
+  std::vector<RoomEvent> Update();
+
+ private:
+  struct Player {
+    Player(TimerWheel& wheel, const Config& config, uint32_t seed, int client);
+
+    int client;
+    RemoteInput input;
+    WheelTimer timer;
+    NintendoClassicScore score;
+    TetriminosGenerator generator;
+    ServerTetris game;
+    int pending_garbage{};
+    int garbage{};         //!< rows sent at last update
+    size_t history{};      //!< actions seen at last update
+    bool alive{true};
+  };
+
+  void Start();
+  int IndexOf(int client) const;
+  const Player& Find(int client) const { return *players[IndexOf(client)]; }
+  void Route(int player, int rows);
+  void Lose(int player);
+  int NextAlive(int player) const;
+
+  TimerWheel& wheel;
+  Config config;
+  uint32_t seed;
+  std::mt19937 holes;
+  std::vector<std::unique_ptr<Player>> players;
+  std::vector<RoomEvent> events;
+  bool started{false};
+  bool settled{false};
+};
+
+}  // namespace tetris
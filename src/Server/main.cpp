@@ -0,0 +1,52 @@
+#include <Server/MatchServer.h>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+//! versus match server, see MatchServer.h for the protocol
+//! usage: tetris_server [--unix path | --port n] [--players n] [--seed n]
+
+using namespace tetris;
+
+namespace {
+
+MatchServer* server{};
+
+void OnStopSignal(int) {
+  if (server)
+    server->Stop();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  MatchServer::Config config;
+  config.port = 7777;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!std::strcmp(argv[i], "--unix"))
+      config.unix_path = argv[i + 1];
+    else if (!std::strcmp(argv[i], "--port"))
+      config.port = static_cast<uint16_t>(std::atoi(argv[i + 1]));
+    else if (!std::strcmp(argv[i], "--players"))
+      config.room.capacity = std::atoi(argv[i + 1]);
+    else if (!std::strcmp(argv[i], "--seed"))
+      config.seed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+  }
+
+  try {
+    MatchServer match_server(config);
+    server = &match_server;
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+    if (config.unix_path.empty())
+      std::cout << "listening on " << config.host << ':' << match_server.Port() << std::endl;
+    else
+      std::cout << "listening on " << config.unix_path << std::endl;
+    match_server.Run();
+    server = nullptr;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
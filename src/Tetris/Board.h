@@ -0,0 +1,267 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Tetris/Tetriminos.h"
+#include "Tetris/Zobrist.h"
+
+namespace tetris {
+
+struct BoardSize {
+  int width{10};
+  int height{25};
+
+  bool operator==(const BoardSize& other) const {
+    return width == other.width && height == other.height;
+  }
+};
+
+//! template argument of BasicBoard meaning "size given at runtime"
+constexpr int kDynamicSize = 0;
+
+//! mask of the @param n lowest bits, n in [0,64]
+inline uint64_t LowBits(int n) {
+  return n >= 64 ? ~uint64_t{0} : (uint64_t{1} << n) - 1;
+}
+
+inline int CountTrailingZeros(uint64_t v) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(v);
+#else
+  int n = 0;
+  while (!(v & 1)) {
+    v >>= 1;
+    n++;
+  }
+  return n;
+#endif
+}
+
+namespace detail {
+
+//! smallest unsigned holding one bit per column
+template <int W>
+using RowMask = std::conditional_t<
+    (W > 0 && W <= 16),
+    uint16_t,
+    std::conditional_t<(W > 0 && W <= 32), uint32_t, uint64_t>>;
+
+template <int W, int H>
+struct BoardStorage {
+  static_assert(W > 0 && W <= 64, "board is limited to 64 columns");
+  static_assert(H > 0 && H <= 64, "board is limited to 64 lines");
+  using Row = RowMask<W>;
+  using Column = RowMask<H>;
+
+  explicit BoardStorage(BoardSize size) {
+    if (!(size == BoardSize{W, H}))
+      throw std::runtime_error("board size does not match its compile time size");
+  }
+
+  static constexpr int Width() { return W; }
+  static constexpr int Height() { return H; }
+
+  std::array<Row, H> rows{};
+  std::array<Column, W> columns{};
+  std::array<Tetriminos::eColor, W * H> colors{};
+};
+
+template <>
+struct BoardStorage<kDynamicSize, kDynamicSize> {
+  using Row = uint64_t;
+  using Column = uint64_t;
+
+  explicit BoardStorage(BoardSize size)
+      : width(ThrowIfInvalid(size).width),
+        height(size.height),
+        rows(height),
+        columns(width),
+        colors(width * height) {}
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+
+  int width;
+  int height;
+  std::vector<Row> rows;
+  std::vector<Column> columns;
+  std::vector<Tetriminos::eColor> colors;
+
+ private:
+  static BoardSize ThrowIfInvalid(BoardSize size) {
+    if (size.width < 1 || size.width > 64)
+      throw std::runtime_error("board width must be in [1,64]");
+    if (size.height < 1 || size.height > 64)
+      throw std::runtime_error("board height must be in [1,64]");
+    return size;
+  }
+};
+
+}  // namespace detail
+
+//! playfield without walls: a bitmask per row for collisions and line clears,
+//! a bitmask per column for drop distances and a color per cell for renderers.
+//! rows are stored in a ring so that pushing rows up from the bottom moves no row.
+//! the Zobrist hash of the occupied cells follows each change
+//! @tparam W,H compile time size, or kDynamicSize to choose it at construction (up to 64x64)
+template <int W = kDynamicSize, int H = kDynamicSize>
+class BasicBoard : detail::BoardStorage<W, H> {
+  using Storage = detail::BoardStorage<W, H>;
+  using Storage::colors;
+  using Storage::columns;
+  using Storage::rows;
+
+ public:
+  using Row = typename Storage::Row;
+  using Column = typename Storage::Column;
+
+  static constexpr BoardSize DefaultSize() {
+    return W == kDynamicSize ? BoardSize{} : BoardSize{W, H};
+  }
+
+  explicit BasicBoard(BoardSize size = DefaultSize()) : Storage(size) {}
+
+  using Storage::Height;
+  using Storage::Width;
+  BoardSize Size() const { return BoardSize{Width(), Height()}; }
+
+  Row FullRow() const {
+    return Width() == 64 ? static_cast<Row>(~Row{0}) : static_cast<Row>((uint64_t{1} << Width()) - 1);
+  }
+  Row RowMask(int y) const { return rows[Physical(y)]; }
+  //! bit y is set when cell (x,y) is occupied
+  Column ColumnMask(int x) const { return columns[x]; }
+  bool IsFull(int y) const { return rows[Physical(y)] == FullRow(); }
+  bool IsEmpty() const {
+    return std::all_of(rows.begin(), rows.end(), [](Row row) { return row == 0; });
+  }
+
+  bool Contains(const Pos& pos) const {
+    return pos.x >= 0 && pos.x < Width() && pos.y >= 0 && pos.y < Height();
+  }
+  //! cells out of the board are free, walls are checked by the engine
+  bool IsOccupied(const Pos& pos) const {
+    return Contains(pos) && ((rows[Physical(pos.y)] >> pos.x) & 1);
+  }
+  Tetriminos::eColor Color(const Pos& pos) const { return colors[Index(pos)]; }
+  //! Zobrist hash of the occupied cells, colors are ignored
+  uint64_t Hash() const { return hash; }
+
+  //! number of free cells under the block at @param pos, floor included
+  int FreeCellsBelow(const Pos& pos) const {
+    const uint64_t below = pos.y < 0 ? columns[pos.x] : columns[pos.x] & ~LowBits(pos.y + 1);
+    const int first_occupied = below ? CountTrailingZeros(below) : Height();
+    return first_occupied - pos.y - 1;
+  }
+
+  //! number of rows @param t can fall before landing, t must be between the walls
+  int DropDistance(const Tetriminos& t) const {
+    const Pos origin = t.Position();
+    int distance = Height();
+    for (const Pos& pos : t.BlocksPosition()) {
+      distance = std::min(distance, FreeCellsBelow(Pos{origin.x + pos.x, origin.y + pos.y}));
+    }
+    return std::max(distance, 0);
+  }
+
+  //!@pre Contains(pos)
+  void Set(const Pos& pos, Tetriminos::eColor color) {
+    if (!IsOccupied(pos))
+      hash ^= zobrist::CellKey(pos.x, pos.y);
+    rows[Physical(pos.y)] |= static_cast<Row>(Row{1} << pos.x);
+    columns[pos.x] |= static_cast<Column>(Column{1} << pos.y);
+    colors[Index(pos)] = color;
+  }
+
+  void ClearRow(int y) {
+    Row& row = rows[Physical(y)];
+    hash ^= RowKey(y, row);
+    for (uint64_t bits = row; bits; bits &= bits - 1) {
+      columns[CountTrailingZeros(bits)] &= static_cast<Column>(~(Column{1} << y));
+    }
+    row = 0;
+  }
+
+  //! all rows above @param line move one row down, top row becomes empty
+  void DropRowsAbove(int line) {
+    for (int y = line; y > 0; y--) {
+      hash ^= RowKey(y, rows[Physical(y)]) ^ RowKey(y, rows[Physical(y - 1)]);
+      rows[Physical(y)] = rows[Physical(y - 1)];
+      std::copy_n(colors.begin() + Index(Pos{0, y - 1}), Width(), colors.begin() + Index(Pos{0, y}));
+    }
+    hash ^= RowKey(0, rows[Physical(0)]);
+    rows[Physical(0)] = 0;
+
+    const uint64_t above = LowBits(line);
+    const uint64_t below = ~LowBits(line + 1);
+    for (auto& column : columns) {
+      column = static_cast<Column>((column & below) | ((column & above) << 1));
+    }
+  }
+
+  //! push every row up by @param nb_rows, the bottom ones become @param row cells of
+  //! @param color. Costs nb_rows row writes and hashes, a shift per column
+  //!@return true if occupied cells were pushed over the ceiling, they are lost
+  bool PushRowsUp(int nb_rows, Row row, Tetriminos::eColor color) {
+    nb_rows = std::min(nb_rows, Height());
+    bool overflow = false;
+    for (int y = 0; y < nb_rows; y++) {
+      overflow |= rows[Physical(y)] != 0;
+      hash ^= RowKey(y, rows[Physical(y)]);
+    }
+    // the remaining cells move nb_rows up, see zobrist::CellKey()
+    hash = zobrist::RotateLeft(hash, (64 - nb_rows) & 63);
+
+    top = Physical(nb_rows);  // rows over the ceiling become the bottom ones
+    for (int y = Height() - nb_rows; y < Height(); y++) {
+      rows[Physical(y)] = row;
+      std::fill_n(colors.begin() + Index(Pos{0, y}), Width(), color);
+    }
+
+    const uint64_t bottom = LowBits(nb_rows) << (Height() - nb_rows);
+    for (int x = 0; x < Width(); x++) {
+      const uint64_t pushed = nb_rows >= 64 ? 0 : uint64_t{columns[x]} >> nb_rows;
+      columns[x] = static_cast<Column>(((row >> x) & 1) ? pushed | bottom : pushed);
+    }
+
+    for (int y = Height() - nb_rows; y < Height(); y++)
+      hash ^= RowKey(y, row);
+    return overflow;
+  }
+
+  //! call f(Pos, eColor) on each occupied cell, top to bottom, left to right
+  template <typename F>
+  void ForEachBlock(F&& f) const {
+    for (int y = 0; y < Height(); y++) {
+      for (uint64_t bits = rows[Physical(y)]; bits; bits &= bits - 1) {
+        Pos pos{CountTrailingZeros(bits), y};
+        f(pos, Color(pos));
+      }
+    }
+  }
+
+ private:
+  //! storage row of row @param y
+  int Physical(int y) const {
+    const int row = y + top;
+    return row >= Height() ? row - Height() : row;
+  }
+  int Index(const Pos& pos) const { return Physical(pos.y) * Width() + pos.x; }
+  //! xor of the keys of the occupied cells of @param row at @param y
+  static uint64_t RowKey(int y, uint64_t row) {
+    uint64_t key = 0;
+    for (; row; row &= row - 1)
+      key ^= zobrist::CellKey(CountTrailingZeros(row), y);
+    return key;
+  }
+
+  int top{};  //!< storage row of row 0
+  uint64_t hash{};
+};
+
+using Board = BasicBoard<>;
+
+}  // namespace tetris
@@ -0,0 +1,58 @@
+#include "EngineStats.h"
+#include <algorithm>
+#include <sstream>
+
+namespace tetris {
+
+void EngineStats::LinesCleared(int nb_line) {
+  clears.at(std::min(std::max(nb_line, 0), kMaxClearedLines))++;
+}
+
+uint64_t EngineStats::Clears(int nb_line) const {
+  if (nb_line < 0 || nb_line > kMaxClearedLines)
+    return 0;
+  return clears[nb_line];
+}
+
+void EngineStats::Record(eEngineOperation op, std::chrono::nanoseconds delay) {
+  auto& timing = timings[static_cast<size_t>(op)];
+  timing.calls++;
+  timing.total += delay;
+  timing.min = std::min(timing.min, delay);
+  timing.max = std::max(timing.max, delay);
+}
+
+std::string EngineStats::ToJson() const {
+  static const std::array<const char*, static_cast<size_t>(eEngineCounter::Count)> counter_names{
+      "collision_left_wall", "collision_right_wall", "collision_floor", "collision_stale_blocks",
+      "rotation_rejected",   "piece_spawned",        "gravity_pass",
+  };
+  static const std::array<const char*, static_cast<size_t>(eEngineOperation::Count)> op_names{
+      "left", "right", "rotate", "fast_down", "hard_drop", "down", "land",
+  };
+
+  std::ostringstream out;
+  out << "{\"counters\":{";
+  for (size_t i = 0; i < counters.size(); i++) {
+    out << (i ? "," : "") << '"' << counter_names[i] << "\":" << counters[i];
+  }
+
+  out << "},\"lines_cleared\":{";
+  for (int nb_line = 1; nb_line <= kMaxClearedLines; nb_line++) {
+    out << (nb_line > 1 ? "," : "") << '"' << nb_line << "\":" << clears[nb_line];
+  }
+
+  out << "},\"timings_ns\":{";
+  for (size_t i = 0; i < timings.size(); i++) {
+    const auto& t = timings[i];
+    const auto min = t.calls ? t.min.count() : 0;
+    out << (i ? "," : "") << '"' << op_names[i] << "\":{\"calls\":" << t.calls
+        << ",\"total\":" << t.total.count() << ",\"min\":" << min << ",\"max\":" << t.max.count()
+        << ",\"mean\":" << t.Mean().count() << '}';
+  }
+  out << "}}";
+
+  return out.str();
+}
+
+}  // namespace tetris
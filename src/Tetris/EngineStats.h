@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace tetris {
+
+enum class eEngineCounter {
+  CollisionLeftWall,
+  CollisionRightWall,
+  CollisionFloor,
+  CollisionStaleBlocks,
+  RotationRejected,
+  PieceSpawned,
+  GravityPass,
+  Count
+};
+
+enum class eEngineOperation { Left, Right, Rotate, FastDown, HardDrop, Down, Land, Count };
+
+//! stats policy of the engine: every hook is an empty inline function
+//! so the production engine pays nothing
+struct NoEngineStats {
+  struct Timing {};
+
+  void Count(eEngineCounter) {}
+  void LinesCleared(int) {}
+  Timing Time(eEngineOperation) { return {}; }
+};
+
+struct OperationTiming {
+  uint64_t calls{};
+  std::chrono::nanoseconds total{};
+  std::chrono::nanoseconds min{std::chrono::nanoseconds::max()};
+  std::chrono::nanoseconds max{};
+
+  std::chrono::nanoseconds Mean() const {
+    return calls ? total / static_cast<int64_t>(calls) : std::chrono::nanoseconds{};
+  }
+};
+
+//! stats policy counting engine operations and timing each call
+//! another policy with the same hooks can be used for tracing
+class EngineStats {
+ public:
+  static constexpr int kMaxClearedLines = 4;
+
+  //! measure the enclosing scope, result is recorded on destruction
+  class Timing {
+   public:
+    Timing(EngineStats& stats_p, eEngineOperation op_p)
+        : stats(stats_p), op(op_p), begin(std::chrono::steady_clock::now()) {}
+    Timing(const Timing&) = delete;
+    Timing& operator=(const Timing&) = delete;
+    ~Timing() { stats.Record(op, std::chrono::steady_clock::now() - begin); }
+
+   private:
+    EngineStats& stats;
+    eEngineOperation op;
+    std::chrono::steady_clock::time_point begin;
+  };
+
+  void Count(eEngineCounter counter) { counters[static_cast<size_t>(counter)]++; }
+  void LinesCleared(int nb_line);
+  Timing Time(eEngineOperation op) { return Timing{*this, op}; }
+
+  uint64_t Counter(eEngineCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+  //!@return number of clears of exactly @param nb_line lines
+  uint64_t Clears(int nb_line) const;
+  const OperationTiming& Timings(eEngineOperation op) const {
+    return timings[static_cast<size_t>(op)];
+  }
+
+  void Reset() { *this = EngineStats{}; }
+
+  std::string ToJson() const;
+
+ private:
+  void Record(eEngineOperation op, std::chrono::nanoseconds delay);
+
+  std::array<uint64_t, static_cast<size_t>(eEngineCounter::Count)> counters{};
+  std::array<uint64_t, kMaxClearedLines + 1> clears{};
+  std::array<OperationTiming, static_cast<size_t>(eEngineOperation::Count)> timings{};
+};
+
+}  // namespace tetris
@@ -0,0 +1,117 @@
+#include "FrameComposer.h"
+#include <algorithm>
+#include <cstdio>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace tetris {
+
+namespace {
+
+//! cursor home, the frame is drawn over the previous one
+constexpr char kHome[] = "\x1b[H";
+constexpr char kPauseText[] = "press <Enter> to start";
+constexpr int kPreviewOffset = 9;  //!< from the panel to the preview tetriminos origin
+
+//! SGR foreground of each eColor, bright colors but orange. Count is the default color
+constexpr const char* kSgr[] = {"\x1b[96m", "\x1b[93m", "\x1b[95m", "\x1b[33m", "\x1b[94m",
+                                "\x1b[91m", "\x1b[92m", "\x1b[90m", "\x1b[39m"};
+constexpr size_t kSgrSize = 5;
+
+}  // namespace
+
+FrameComposer::FrameComposer(BoardSize board_size, bool colors_p)
+    : width(board_size.width),
+      height(board_size.height),
+      panel(std::max(kPanelColumn, board_size.width + 4)),
+      columns(panel + 24),
+      rows(std::max(board_size.height + 1, kPauseRow + 1)),
+      prefix(sizeof(kHome) - 1),
+      colors(colors_p) {
+  frame.assign(Index(0, rows), ' ');
+  inks.assign(frame.size(), Tetriminos::eColor::Count);
+  if (colors)
+    colored.reserve(frame.size() * (kSgrSize + 1) + kSgrSize);  // a color per cell at worst
+  std::copy_n(kHome, prefix, frame.begin());
+  for (int y = 0; y < rows; y++)
+    frame[Index(columns, y)] = '\n';
+
+  // static layout
+  for (int y = 0; y <= height; y++) {
+    frame[Index(0, y)] = '#';
+    frame[Index(width + 1, y)] = '#';
+  }
+  std::fill_n(frame.begin() + Index(0, height), width + 2, '#');
+  Put(panel, kNextRow, "next:");
+  Put(panel, kScoreRow, "score:");
+  Put(panel, kLinesRow, "lines:");
+  Put(panel, kLevelRow, "level:");
+}
+
+void FrameComposer::Put(int x, int y, const std::string& text) {
+  dirty = true;
+  std::copy(text.begin(), text.end(), frame.begin() + Index(x, y));
+}
+
+void FrameComposer::PutNumber(int y, int value, int& shown) {
+  if (!first && value == shown)
+    return;
+  shown = value;
+  char digits[kFieldWidth + 1];
+  std::snprintf(digits, sizeof(digits), "%-*d", kFieldWidth, value);
+  Put(panel + 7, y, digits);
+  renders.numbers++;
+}
+
+void FrameComposer::PutPreview(Tetriminos next) {
+  next_type = next.Type();
+  dirty = true;
+  for (int y = kNextRow - 2; y <= kNextRow + 2; y++)
+    std::fill_n(frame.begin() + Index(panel + kPreviewOffset - 2, y), 6, ' ');
+  next.SetX(panel + kPreviewOffset);
+  next.SetY(kNextRow);
+  for (const Pos& p : next.BlocksAbsolutePosition()) {
+    frame[Index(p.x, p.y)] = '@';
+    inks[Index(p.x, p.y)] = next.ColorHint();
+  }
+  renders.preview++;
+}
+
+void FrameComposer::PutPause(bool paused_p) {
+  paused = paused_p;
+  const std::string text(kPauseText);
+  Put(panel, kPauseRow, paused ? text : std::string(text.size(), ' '));
+  renders.pause++;
+}
+
+void FrameComposer::Colorize() {
+  colored.assign(frame, 0, prefix);
+  auto ink = Tetriminos::eColor::Count;
+  for (size_t i = prefix; i < frame.size(); i++) {
+    const char c = frame[i];
+    if (inks[i] != ink && c != ' ' && c != '\n') {
+      ink = inks[i];
+      colored.append(kSgr[static_cast<int>(ink)], kSgrSize);
+    }
+    colored += c;
+  }
+  if (ink != Tetriminos::eColor::Count)  // the next frame starts with the default color
+    colored.append(kSgr[static_cast<int>(Tetriminos::eColor::Count)], kSgrSize);
+  dirty = false;
+  renders.colored++;
+}
+
+bool FrameComposer::Write(int fd) const {
+  const std::string& bytes = Frame();
+#if defined(_WIN32)
+  const auto written = _write(fd, bytes.data(), static_cast<unsigned>(bytes.size()));
+#else
+  const auto written = write(fd, bytes.data(), bytes.size());
+#endif
+  return written >= 0 && static_cast<size_t>(written) == bytes.size();
+}
+
+}  // namespace tetris
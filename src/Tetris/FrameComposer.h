@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Tetris/Tetris.h"
+
+namespace tetris {
+
+//! console frame of a game: the static layout (walls, floor, labels) is rendered once,
+//! then each Compose() only renders the playfield, the preview and the numbers that
+//! changed, in place. The frame is a single preallocated buffer, cursor home included,
+//! sent with one write()
+//!
+//! in colored mode, cells keep the color of their tetriminos and the sent frame is built
+//! from the cells: a color escape is emitted only where the color of the visible cells
+//! changes, blanks take any color
+class FrameComposer {
+ public:
+  //! screen cells, 0 based. The panel is on the right of the playfield
+  static constexpr int kPanelColumn = 14;
+  static constexpr int kNextRow = 6;
+  static constexpr int kScoreRow = 12;
+  static constexpr int kLinesRow = 13;
+  static constexpr int kLevelRow = 14;
+  static constexpr int kPauseRow = 18;
+  static constexpr int kFieldWidth = 10;  //!< digits shown of a number
+
+  //! how many times each region was rendered
+  struct Renders {
+    uint64_t playfield{};
+    uint64_t preview{};
+    uint64_t numbers{};
+    uint64_t pause{};
+    uint64_t colored{};  //!< colored frames built, once per Compose() that rendered a region
+  };
+
+  //!@param colors ANSI colored cells
+  explicit FrameComposer(BoardSize board_size, bool colors = false);
+
+  //!@return the frame of @param game
+  template <class Traits>
+  const std::string& Compose(const BasicTetris<Traits>& game);
+
+  //! compose and write the frame on @param fd with a single write()
+  //!@return false if the frame was not written entirely
+  template <class Traits>
+  bool Draw(const BasicTetris<Traits>& game, int fd = 1) {
+    Compose(game);
+    return Write(fd);
+  }
+  bool Write(int fd) const;
+
+  //! bytes sent by Write()
+  const std::string& Frame() const { return colors ? colored : frame; }
+  int Columns() const { return columns; }
+  int Rows() const { return rows; }
+  //! text of screen row @param y, without the line feed nor colors
+  std::string Line(int y) const { return frame.substr(Index(0, y), columns); }
+  const Renders& Rendered() const { return renders; }
+
+ private:
+  //! position of screen cell (x,y) in the frame
+  size_t Index(int x, int y) const { return prefix + static_cast<size_t>(y) * (columns + 1) + x; }
+  void Put(int x, int y, const std::string& text);
+  void PutNumber(int y, int value, int& shown);
+  void PutPreview(Tetriminos next);
+  void PutPause(bool paused);
+  //! playfield cell (x,y), walls are around
+  void Cell(int x, int y, char c, Tetriminos::eColor ink) {
+    dirty = true;
+    const size_t i = Index(x + 1, y);
+    frame[i] = c;
+    inks[i] = ink;
+  }
+  //! build the colored frame from the cells
+  void Colorize();
+
+  int width;
+  int height;
+  int panel;  //!< first column of the labels
+  int columns;
+  int rows;
+  size_t prefix;
+  std::string frame;  //!< cells, sent as is without colors
+  bool colors;
+  std::vector<Tetriminos::eColor> inks;  //!< color of each cell of the frame, Count is none
+  std::string colored;
+  Renders renders;
+
+  // rendered values, a region is rendered again when they change
+  bool first{true};
+  bool dirty{true};  //!< a region was rendered since the last Colorize()
+  uint64_t playfield_hash{};
+  Tetriminos::eType next_type{};
+  int score{};
+  int lines{};
+  int level{};
+  bool paused{};
+};
+
+template <class Traits>
+const std::string& FrameComposer::Compose(const BasicTetris<Traits>& game) {
+  // the hash covers the stale blocks and the current tetriminos, the ghost follows them
+  if (first || game.Hash() != playfield_hash) {
+    playfield_hash = game.Hash();
+    const auto& board = game.Playfield();
+    for (int y = 0; y < height; y++) {
+      const auto row = board.RowMask(y);
+      for (int x = 0; x < width; x++) {
+        if ((row >> x) & 1)
+          Cell(x, y, 'x', board.Color(Pos{x, y}));
+        else
+          Cell(x, y, ' ', Tetriminos::eColor::Count);
+      }
+    }
+    const auto ink = game.Current().ColorHint();
+    for (const Pos& p : game.Ghost().BlocksAbsolutePosition()) {
+      if (p.y >= 0 && !board.IsOccupied(p))
+        Cell(p.x, p.y, '.', ink);
+    }
+    for (const Pos& p : game.Current().BlocksAbsolutePosition()) {
+      if (p.y >= 0)
+        Cell(p.x, p.y, '@', ink);
+    }
+    renders.playfield++;
+  }
+
+  if (first || game.Next().Type() != next_type)
+    PutPreview(game.Next());
+  PutNumber(kScoreRow, game.Scoring().Score(), score);
+  PutNumber(kLinesRow, game.Scoring().CompletedLines(), lines);
+  PutNumber(kLevelRow, game.Scoring().Level(), level);
+  if (first || game.IsPause() != paused)
+    PutPause(game.IsPause());
+  first = false;
+  if (colors && dirty)
+    Colorize();
+  return Frame();
+}
+
+}  // namespace tetris
@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace tetris {
+
+constexpr int kFramesPerSecond = 60;
+
+//! frames elapsed in @param delay, rounded up
+constexpr int64_t FramesOf(std::chrono::milliseconds delay) {
+  return (delay.count() * kFramesPerSecond + 999) / 1000;
+}
+
+//! fall speed in cells per 60Hz frame, 16.16 fixed point
+//! accumulated frame after frame it gives the same fall as the original games, without drift
+struct Gravity {
+  static constexpr int32_t kCell = 1 << 16;
+
+  int32_t per_frame{};
+
+  //! @param g cells per frame, 1G is a cell each frame
+  //! rounded up so that a cell never falls a frame late
+  static constexpr Gravity FromG(double g) {
+    const double per_frame = g * kCell;
+    const auto truncated = static_cast<int32_t>(per_frame);
+    return Gravity{truncated < per_frame ? truncated + 1 : truncated};
+  }
+  //! a cell every @param frames frames
+  static constexpr Gravity FromFramesPerCell(int frames) {
+    return Gravity{(kCell + frames - 1) / frames};
+  }
+  //! a cell every @param period, a null period is the fastest gravity
+  static constexpr Gravity FromPeriod(std::chrono::milliseconds period) {
+    if (period.count() <= 0)
+      return Max();
+    const int64_t frames_per_cell = kFramesPerSecond * period.count();  // in 1/1000 frames
+    const int64_t per_frame = (int64_t{kCell} * 1000 + frames_per_cell - 1) / frames_per_cell;
+    return Gravity{static_cast<int32_t>(per_frame)};
+  }
+  //! 20G, tetriminos cross a 20 rows playfield in one frame
+  static constexpr Gravity Max() { return Gravity{20 * kCell}; }
+
+  constexpr bool operator==(const Gravity& other) const { return per_frame == other.per_frame; }
+};
+
+}  // namespace tetris
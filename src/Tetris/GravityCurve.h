@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include "Tetris/Gravity.h"
+#include "Tetris/IScore.h"
+
+namespace tetris {
+
+//! fall speed of each level, drop periods and frames are computed once at compile time
+//! @example constexpr GravityCurve kCurve{std::array<double, 3>{0.02, 0.1, 1}};
+template <size_t N>
+class GravityCurve {
+  static_assert(N > 0, "a gravity curve needs a level");
+
+ public:
+  //!@param g cells per frame of levels 1 to N, must be positive
+  constexpr explicit GravityCurve(const std::array<double, N>& g) {
+    for (size_t i = 0; i < N; i++) {
+      // truncated to milliseconds, at least one so that timers can run it
+      periods[i] = std::max(static_cast<int64_t>(1000 / (g[i] * kFramesPerSecond)), int64_t{1});
+      gravities[i] = Gravity::FromG(g[i]);
+      frames[i] = (Gravity::kCell + gravities[i].per_frame - 1) / gravities[i].per_frame;
+    }
+  }
+
+  static constexpr int Levels() { return static_cast<int>(N); }
+
+  //! levels out of the curve use its first or last level
+  constexpr std::chrono::milliseconds DropPeriod(int level) const {
+    return std::chrono::milliseconds{periods[Index(level)]};
+  }
+  constexpr Gravity GravityPerFrame(int level) const { return gravities[Index(level)]; }
+  //! frames before the first cell falls, 1 from 1G
+  constexpr int FramesPerCell(int level) const { return frames[Index(level)]; }
+
+ private:
+  static constexpr size_t Index(int level) {
+    return static_cast<size_t>(std::min(std::max(level, 1), Levels()) - 1);
+  }
+
+  std::array<int64_t, N> periods{};
+  std::array<Gravity, N> gravities{};
+  std::array<int, N> frames{};
+};
+
+//! IScore taking its drop periods and gravities from a compile time curve
+//! @example constexpr GravityCurve kCurve{...};
+//!          class MyScore : public CurveScore<kCurve> { ... };
+template <const auto& Curve>
+struct CurveScore : IScore {
+  std::chrono::milliseconds DropPeriod(int level = 0) const override {
+    return Curve.DropPeriod(level > 0 ? level : Level());
+  }
+  Gravity GravityPerFrame(int level = 0) const override {
+    return Curve.GravityPerFrame(level > 0 ? level : Level());
+  }
+};
+
+}  // namespace tetris
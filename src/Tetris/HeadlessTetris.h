@@ -0,0 +1,20 @@
+#pragma once
+#include "Tetris/NintendoClassicScore.h"
+#include "Tetris/Tetris.h"
+#include "Tetris/VirtualTimer.h"
+
+namespace tetris {
+
+//! engine for bots and simulations: concrete collaborators, no virtual call from the engine
+//! to the score, the timer or the generator
+struct HeadlessTraits : DefaultTraits {
+  using Score = NintendoClassicScore;
+  using Timer = VirtualTimer;
+  using Generator = TetriminosGenerator;
+};
+
+using HeadlessTetris = BasicTetris<HeadlessTraits>;
+
+extern template class BasicTetris<HeadlessTraits>;
+
+}  // namespace tetris
@@ -1,5 +1,6 @@
 #pragma once
 #include <chrono>
+#include "Tetris/Gravity.h"
 
 namespace tetris {
 
@@ -13,6 +14,8 @@ struct IScore {
   virtual bool OnCompletedLine(int nb_line) = 0;
   virtual void OnPerfectClear() = 0;
   virtual void OnSoftDrop() = 0;
+  //!@param nb_cells number of rows skipped by the hard drop, no points by default
+  virtual void OnHardDrop(int /*nb_cells*/) {}
 
   virtual int Score() const = 0;
 
@@ -23,6 +26,12 @@ struct IScore {
 
   //!@param level = 0 mean, with current level
   virtual std::chrono::milliseconds DropPeriod(int level = 0) const = 0;
+
+  //! fall speed of frame driven games, derived from DropPeriod by default
+  //!@param level = 0 mean, with current level
+  virtual Gravity GravityPerFrame(int level = 0) const {
+    return Gravity::FromPeriod(DropPeriod(level));
+  }
 };
 
 };  // namespace tetris
\ No newline at end of file
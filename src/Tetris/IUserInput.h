@@ -1,10 +1,13 @@
 #pragma once
+#include "Tetris/LatencyProbe.h"
 namespace tetris {
 enum class UserEvent {
   Left,
   Right,
   Rotate,
+  ReverseRotate,
   FastDown,
+  HardDrop,
   Pause,
   Resume,
 };
@@ -13,12 +16,24 @@ struct InputListener {
   virtual void OnLeft() = 0;
   virtual void OnRight() = 0;
   virtual void OnRotate() = 0;
+  virtual void OnReverseRotate() = 0;
   virtual void OnFastDown() = 0;
+  virtual void OnHardDrop() = 0;
   virtual void OnPause() = 0;
   virtual void OnResume() = 0;
 };
 
-enum class eInputKey { Left = 0, Right, Rotate, FastDown, Pause, Resume, Count };
+enum class eInputKey {
+  Left = 0,
+  Right,
+  Rotate,
+  ReverseRotate,
+  FastDown,
+  HardDrop,
+  Pause,
+  Resume,
+  Count
+};
 
 struct UserInput {
   void SetListener(InputListener& listener_p) { listener = &listener_p; }
@@ -28,6 +43,8 @@ struct UserInput {
     if (!listener)
       return;
 
+    TETRIS_LATENCY_PROBE(Fire);
+
     switch (key) {
       case eInputKey::Left:
         listener->OnLeft();
@@ -38,9 +55,15 @@ struct UserInput {
       case eInputKey::Rotate:
         listener->OnRotate();
         break;
+      case eInputKey::ReverseRotate:
+        listener->OnReverseRotate();
+        break;
       case eInputKey::FastDown:
         listener->OnFastDown();
         break;
+      case eInputKey::HardDrop:
+        listener->OnHardDrop();
+        break;
       case eInputKey::Pause:
         listener->OnPause();
         break;
@@ -0,0 +1,135 @@
+#include "ImageWriter.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+constexpr std::array<uint32_t, 256> MakeCrcTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t n = 0; n < 256; n++) {
+    uint32_t c = n;
+    for (int k = 0; k < 8; k++)
+      c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+    table[n] = c;
+  }
+  return table;
+}
+
+constexpr auto kCrcTable = MakeCrcTable();
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+  uint32_t c = 0xffffffffu;
+  for (size_t i = 0; i < size; i++)
+    c = kCrcTable[(c ^ data[i]) & 0xff] ^ (c >> 8);
+  return c ^ 0xffffffffu;
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+  constexpr uint32_t kBase = 65521;
+  constexpr size_t kBlock = 5552;  //!< largest block without 32 bits overflow
+  uint32_t a = 1;
+  uint32_t b = 0;
+  while (size) {
+    const size_t n = std::min(size, kBlock);
+    for (size_t i = 0; i < n; i++) {
+      a += data[i];
+      b += a;
+    }
+    a %= kBase;
+    b %= kBase;
+    data += n;
+    size -= n;
+  }
+  return b << 16 | a;
+}
+
+void PutU32(std::vector<uint8_t>& out, uint32_t v) {
+  out.insert(out.end(), {static_cast<uint8_t>(v >> 24), static_cast<uint8_t>(v >> 16),
+                         static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v)});
+}
+
+//! chunk of @param type, its data appended by @param data
+template <class F>
+void PutChunk(std::vector<uint8_t>& out, const char (&type)[5], F&& data) {
+  const size_t begin = out.size();
+  PutU32(out, 0);  // length, set once the data is appended
+  out.insert(out.end(), type, type + 4);
+  data();
+  const auto length = static_cast<uint32_t>(out.size() - begin - 8);
+  for (int i = 0; i < 4; i++)
+    out[begin + i] = static_cast<uint8_t>(length >> (24 - 8 * i));
+  PutU32(out, Crc32(out.data() + begin + 4, length + 4));
+}
+
+}  // namespace
+
+ImageSequenceWriter::ImageSequenceWriter(std::ostream& out_p, eFormat format_p)
+    : out(out_p), format(format_p) {}
+
+void ImageSequenceWriter::Write(const uint8_t* rgba, int width, int height) {
+  if (width <= 0 || height <= 0)
+    throw std::runtime_error("empty image");
+  encoded.clear();
+  if (format == eFormat::Ppm)
+    EncodePpm(rgba, width, height);
+  else
+    EncodePng(rgba, width, height);
+  out.write(reinterpret_cast<const char*>(encoded.data()),
+            static_cast<std::streamsize>(encoded.size()));
+  if (!out)
+    throw std::runtime_error("image sequence stream failed");
+  frames++;
+}
+
+void ImageSequenceWriter::EncodePpm(const uint8_t* rgba, int width, int height) {
+  char header[32];
+  const int n = std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+  encoded.insert(encoded.end(), header, header + n);
+  const size_t nb_pixels = static_cast<size_t>(width) * height;
+  encoded.resize(n + nb_pixels * 3);
+  uint8_t* rgb = encoded.data() + n;
+  for (size_t i = 0; i < nb_pixels; i++, rgb += 3, rgba += 4)
+    std::copy_n(rgba, 3, rgb);
+}
+
+void ImageSequenceWriter::EncodePng(const uint8_t* rgba, int width, int height) {
+  // scanlines of filter type None
+  const size_t stride = static_cast<size_t>(width) * 4;
+  scanlines.resize((stride + 1) * height);
+  for (int y = 0; y < height; y++) {
+    uint8_t* line = scanlines.data() + (stride + 1) * y;
+    line[0] = 0;
+    std::copy_n(rgba + stride * y, stride, line + 1);
+  }
+
+  static constexpr uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  encoded.insert(encoded.end(), std::begin(kSignature), std::end(kSignature));
+  PutChunk(encoded, "IHDR", [&] {
+    PutU32(encoded, static_cast<uint32_t>(width));
+    PutU32(encoded, static_cast<uint32_t>(height));
+    encoded.insert(encoded.end(), {8, 6, 0, 0, 0});  // 8 bits RGBA, deflate, no interlace
+  });
+  PutChunk(encoded, "IDAT", [&] {
+    constexpr size_t kStoredMax = 65535;
+    encoded.insert(encoded.end(), {0x78, 0x01});  // zlib, 32K window, no compression
+    size_t done = 0;
+    do {
+      const size_t n = std::min(kStoredMax, scanlines.size() - done);
+      const bool last = done + n == scanlines.size();
+      encoded.insert(encoded.end(),
+                     {static_cast<uint8_t>(last), static_cast<uint8_t>(n),
+                      static_cast<uint8_t>(n >> 8), static_cast<uint8_t>(~n),
+                      static_cast<uint8_t>(~n >> 8)});
+      encoded.insert(encoded.end(), scanlines.begin() + done, scanlines.begin() + done + n);
+      done += n;
+    } while (done < scanlines.size());
+    PutU32(encoded, Adler32(scanlines.data(), scanlines.size()));
+  });
+  PutChunk(encoded, "IEND", [] {});
+}
+
+}  // namespace tetris
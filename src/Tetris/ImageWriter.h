@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Tetris/Rasterizer.h"
+
+namespace tetris {
+
+//! streaming writer of image sequences: the images are appended to one stream, the way
+//! video encoders read them (e.g. ffmpeg -f image2pipe -i - highlight.gif), or one image
+//! per stream for thumbnails. Encoding buffers are reused from one image to the next
+//!
+//! PNG are not compressed (stored deflate blocks) to be written at thousands of frames per
+//! second, the video encoder compresses the sequence anyway
+class ImageSequenceWriter {
+ public:
+  enum class eFormat { Ppm, Png };
+
+  ImageSequenceWriter(std::ostream& out, eFormat format);
+
+  //! append the image of @param rgba pixels, row after row from the top. PPM drops alpha
+  //! throws when the stream fails
+  void Write(const uint8_t* rgba, int width, int height);
+  void Write(const Rasterizer& image) {
+    Write(image.Pixels().data(), image.Width(), image.Height());
+  }
+
+  //! number of images written
+  size_t Frames() const { return frames; }
+
+ private:
+  void EncodePpm(const uint8_t* rgba, int width, int height);
+  void EncodePng(const uint8_t* rgba, int width, int height);
+
+  std::ostream& out;
+  eFormat format;
+  std::vector<uint8_t> scanlines;  //!< PNG filtered image
+  std::vector<uint8_t> encoded;
+  size_t frames{};
+};
+
+}  // namespace tetris
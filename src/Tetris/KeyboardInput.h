@@ -79,11 +79,21 @@ struct KeyBoardInputsBuilder {
     return Assign(eInputKey::Rotate, user_key);
   }
 
+  template <typename T>
+  KeyBoardInputsBuilder& AssignReverseRotate(T user_key) {
+    return Assign(eInputKey::ReverseRotate, user_key);
+  }
+
   template <typename T>
   KeyBoardInputsBuilder& AssignMoveDown(T user_key) {
     return Assign(eInputKey::FastDown, user_key);
   }
 
+  template <typename T>
+  KeyBoardInputsBuilder& AssignHardDrop(T user_key) {
+    return Assign(eInputKey::HardDrop, user_key);
+  }
+
   template <typename T>
   KeyBoardInputsBuilder& AssignPause(T user_key) {
     return Assign(eInputKey::Pause, user_key);
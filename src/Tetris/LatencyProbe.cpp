@@ -0,0 +1,130 @@
+#include "LatencyProbe.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace tetris {
+
+static int MostSignificantBit(uint64_t v) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(v);
+#else
+  int msb = 0;
+  while (v >>= 1)
+    msb++;
+  return msb;
+#endif
+}
+
+int LatencyHistogram::BucketIndex(uint64_t ns) {
+  if (ns < kSubBuckets)
+    return static_cast<int>(ns);
+
+  const int shift = MostSignificantBit(ns) - kSubBucketBits;
+  const int sub = static_cast<int>(ns >> shift) - kSubBuckets;
+  return (shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index) {
+  if (index < kSubBuckets)
+    return static_cast<uint64_t>(index);
+
+  const int shift = index / kSubBuckets - 1;
+  const uint64_t sub = index % kSubBuckets;
+  const uint64_t lower = (kSubBuckets + sub) << shift;
+  return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds delay) {
+  const auto ns = static_cast<uint64_t>(std::max<int64_t>(delay.count(), 0));
+  buckets[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets)
+    bucket.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Count() const {
+  uint64_t count{};
+  for (const auto& bucket : buckets)
+    count += bucket.load(std::memory_order_relaxed);
+  return count;
+}
+
+std::chrono::nanoseconds LatencyHistogram::Percentile(double ratio) const {
+  const uint64_t count = Count();
+  if (count == 0)
+    return std::chrono::nanoseconds{0};
+
+  ratio = std::min(std::max(ratio, 0.0), 1.0);
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(ratio * count)));
+
+  uint64_t cumul{};
+  for (int i = 0; i < kBuckets; i++) {
+    cumul += buckets[i].load(std::memory_order_relaxed);
+    if (cumul >= rank)
+      return std::chrono::nanoseconds{BucketUpperBound(i)};
+  }
+  return std::chrono::nanoseconds{BucketUpperBound(kBuckets - 1)};
+}
+
+std::ostream& operator<<(std::ostream& out, const eLatencyProbe& probe) {
+  static std::array<const char*, static_cast<size_t>(eLatencyProbe::Count)> names{
+      "key read",
+      "fire",
+      "engine",
+      "render",
+  };
+  return out << names.at(static_cast<size_t>(probe));
+}
+
+LatencyTracer& LatencyTracer::Instance() {
+  static LatencyTracer tracer;
+  return tracer;
+}
+
+int64_t LatencyTracer::Now() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyTracer::Begin() {
+  begin_ns.store(Now(), std::memory_order_relaxed);
+}
+
+void LatencyTracer::Mark(eLatencyProbe probe) {
+  const int64_t begin = begin_ns.load(std::memory_order_relaxed);
+  if (begin == 0)
+    return;
+  histograms[static_cast<size_t>(probe)].Record(std::chrono::nanoseconds{Now() - begin});
+}
+
+void LatencyTracer::End() {
+  Mark(eLatencyProbe::Render);
+  begin_ns.store(0, std::memory_order_relaxed);
+}
+
+void LatencyTracer::Cancel() {
+  begin_ns.store(0, std::memory_order_relaxed);
+}
+
+void LatencyTracer::Reset() {
+  begin_ns.store(0, std::memory_order_relaxed);
+  for (auto& histogram : histograms)
+    histogram.Reset();
+}
+
+void LatencyTracer::Dump(std::ostream& out) const {
+  auto us = [](std::chrono::nanoseconds ns) { return ns.count() / 1000.0; };
+
+  out << "latency since key available (us)\n";
+  for (size_t i = 0; i < histograms.size(); i++) {
+    const auto& h = histograms[i];
+    out << std::setw(10) << static_cast<eLatencyProbe>(i) << "  count: " << h.Count()
+        << "  p50: " << us(h.Percentile(0.5)) << "  p99: " << us(h.Percentile(0.99))
+        << "  p999: " << us(h.Percentile(0.999)) << "  max: " << us(h.Max()) << '\n';
+  }
+}
+
+}  // namespace tetris
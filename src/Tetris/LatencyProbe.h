@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace tetris {
+
+//! lock free latency histogram with log-linear buckets (16 sub buckets per power of two)
+//! Record() can be called from any thread, relative error of percentiles is below 6.25%
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kBuckets = 64 * kSubBuckets;
+
+  void Record(std::chrono::nanoseconds delay);
+  void Reset();
+
+  uint64_t Count() const;
+  //!@param ratio in [0,1] ,  0.5 => p50, 0.999 => p999
+  //!@return upper bound of the bucket holding the requested rank
+  std::chrono::nanoseconds Percentile(double ratio) const;
+  std::chrono::nanoseconds Max() const { return Percentile(1.0); }
+
+  static int BucketIndex(uint64_t ns);
+  static uint64_t BucketUpperBound(int index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+};
+
+//! probes along the input path, each one measures the delay since the key was available
+enum class eLatencyProbe { KeyRead = 0, Fire, Engine, Render, Count };
+
+std::ostream& operator<<(std::ostream& out, const eLatencyProbe& probe);
+
+//! collects keypress to rendered frame latencies
+//! a sample is opened by Begin() (key available) and closed by End() (frame rendered)
+//! probes marked outside of a sample (timer driven redraws...) are ignored
+class LatencyTracer {
+ public:
+  static LatencyTracer& Instance();
+
+  void Begin();
+  void Mark(eLatencyProbe probe);
+  void End();
+  //! close the sample without recording it, i.e. the key did not render a frame
+  void Cancel();
+
+  const LatencyHistogram& Histogram(eLatencyProbe probe) const {
+    return histograms[static_cast<size_t>(probe)];
+  }
+  void Reset();
+
+  //! one line per probe: count p50 p99 p999 max
+  void Dump(std::ostream& out) const;
+
+ private:
+  static int64_t Now();
+
+  std::atomic<int64_t> begin_ns{0};
+  std::array<LatencyHistogram, static_cast<size_t>(eLatencyProbe::Count)> histograms;
+};
+
+//! mark a probe when leaving the scope, handy for functions with early returns
+struct LatencyScope {
+  explicit LatencyScope(eLatencyProbe probe_p) : probe(probe_p) {}
+  ~LatencyScope() { LatencyTracer::Instance().Mark(probe); }
+
+ private:
+  eLatencyProbe probe;
+};
+
+}  // namespace tetris
+
+// probes compile to nothing unless TETRIS_WITH_LATENCY_PROBES is defined (cmake option)
+#if defined(TETRIS_WITH_LATENCY_PROBES)
+#define TETRIS_LATENCY_BEGIN() ::tetris::LatencyTracer::Instance().Begin()
+#define TETRIS_LATENCY_PROBE(probe) \
+  ::tetris::LatencyTracer::Instance().Mark(::tetris::eLatencyProbe::probe)
+#define TETRIS_LATENCY_SCOPE(probe) \
+  ::tetris::LatencyScope tetris_latency_scope_##probe { ::tetris::eLatencyProbe::probe }
+#define TETRIS_LATENCY_END() ::tetris::LatencyTracer::Instance().End()
+#define TETRIS_LATENCY_CANCEL() ::tetris::LatencyTracer::Instance().Cancel()
+#else
+#define TETRIS_LATENCY_BEGIN() ((void)0)
+#define TETRIS_LATENCY_PROBE(probe) ((void)0)
+#define TETRIS_LATENCY_SCOPE(probe) ((void)0)
+#define TETRIS_LATENCY_END() ((void)0)
+#define TETRIS_LATENCY_CANCEL() ((void)0)
+#endif
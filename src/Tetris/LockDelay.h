@@ -0,0 +1,102 @@
+#pragma once
+#include <chrono>
+#include <limits>
+
+namespace tetris {
+
+//! how long a tetriminos touching the ground waits before locking, see https://tetris.wiki/Lock_delay
+//! the delay is game time: the engine runs it on its ITimer, never on the wall clock
+class LockDelay {
+ public:
+  enum class eReset {
+    OnMove,  //!< a move or a rotation restarts the delay
+    OnStep,  //!< only reaching a lower row restarts the delay
+  };
+  static constexpr int kUnlimited = std::numeric_limits<int>::max();
+
+  //! lock on the first gravity step that can not go down
+  static constexpr LockDelay Classic() { return LockDelay{}; }
+  //! moves and rotations restart the delay without limit
+  static constexpr LockDelay Infinite(std::chrono::milliseconds delay) {
+    return LockDelay{delay, eReset::OnMove, kUnlimited};
+  }
+  //! moves and rotations restart the delay up to @param max_resets times,
+  //! the count starts again each time a lower row is reached
+  static constexpr LockDelay MoveReset(std::chrono::milliseconds delay, int max_resets = 15) {
+    return LockDelay{delay, eReset::OnMove, max_resets};
+  }
+  //! moves and rotations do not restart the delay, falling to a lower row does
+  static constexpr LockDelay StepReset(std::chrono::milliseconds delay) {
+    return LockDelay{delay, eReset::OnStep, 0};
+  }
+
+  constexpr std::chrono::milliseconds Delay() const { return delay; }
+  constexpr eReset Reset() const { return reset; }
+  constexpr int MaxResets() const { return max_resets; }
+  constexpr bool IsImmediate() const { return delay.count() <= 0; }
+
+ private:
+  constexpr LockDelay() = default;
+  constexpr LockDelay(std::chrono::milliseconds delay_p, eReset reset_p, int max_resets_p)
+      : delay(delay_p), reset(reset_p), max_resets(max_resets_p) {}
+
+  std::chrono::milliseconds delay{};
+  eReset reset{eReset::OnStep};
+  int max_resets{};
+};
+
+//! lock delay state of the falling tetriminos, rows grow downward. Rows are the lowest
+//! row of the tetriminos blocks: rotations move its origin, not how low it went
+class LockCountdown {
+ public:
+  explicit LockCountdown(LockDelay policy_p = LockDelay::Classic()) : policy(policy_p) {}
+
+  const LockDelay& Policy() const { return policy; }
+  bool IsRunning() const { return running; }
+  int Resets() const { return resets; }
+
+  void OnSpawn(int row) {
+    running = false;
+    resets = 0;
+    lowest_row = row;
+  }
+
+  //! gravity can not move the tetriminos
+  //!@return true if it locks now, else the countdown starts. Landing again on a row
+  //! already reached, after a kick lifted the tetriminos, starts it with the resets done
+  bool OnBlocked() {
+    if (policy.IsImmediate() || running)
+      return true;
+    running = true;
+    return false;
+  }
+
+  //! the tetriminos fell to @param row
+  //!@return true if the countdown was stopped
+  bool OnFall(int row) {
+    if (row > lowest_row) {
+      lowest_row = row;
+      resets = 0;
+    }
+    const bool was_running = running;
+    running = false;
+    return was_running;
+  }
+
+  //! the tetriminos moved or rotated
+  //!@return true if the countdown restarts
+  bool OnMove() {
+    if (!running || policy.Reset() != LockDelay::eReset::OnMove || resets >= policy.MaxResets())
+      return false;
+    resets++;
+    return true;
+  }
+
+ private:
+  LockDelay policy;
+  bool running{false};
+  int resets{};
+  int lowest_row{};
+};
+
+}  // namespace tetris
@@ -13,20 +13,12 @@ bool NintendoClassicScore::OnCompletedLine(int nb_line) {
   return level != Level();
 }
 
-std::chrono::milliseconds NintendoClassicScore::DropPeriod(int level_p) const {
-  // with block size of 1u, G(level) is  the move for 1 frame at 60Hz
-
-  const std::array<double, 20> G{0,      0.01667, 0.021017, 0.026977, 0.035256, 0.04693, 0.06361,
-
-                                 0.0879, 0.1236,  0.1775,   0.2598,   0.388,    0.59,    0.92,
-
-                                 1.46,   2.36,    3.91,     6.61,     11.43,    20};
-
-  const int level = std::min(std::max(level_p, Level()), 19);
-
-  auto millis = static_cast<int>(1000 / (G.at(level) * 60.0));
-
-  return std::chrono::milliseconds(millis);
+std::chrono::milliseconds NintendoClassicScore::DropPeriod(int level) const {
+  return kNintendoClassicGravity.DropPeriod(std::max(level, Level()));
 };
 
+Gravity NintendoClassicScore::GravityPerFrame(int level) const {
+  return kNintendoClassicGravity.GravityPerFrame(std::max(level, Level()));
+}
+
 }  // namespace tetris
\ No newline at end of file
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <chrono>
+#include "Tetris/GravityCurve.h"
 #include "Tetris/IScore.h"
 
 namespace tetris {
 
+//! G of levels 1 to 19, with block size of 1u G(level) is the move for 1 frame at 60Hz
+inline constexpr GravityCurve kNintendoClassicGravity{std::array<double, 19>{
+    0.01667, 0.021017, 0.026977, 0.035256, 0.04693, 0.06361, 0.0879, 0.1236, 0.1775, 0.2598,
+    0.388, 0.59, 0.92, 1.46, 2.36, 3.91, 6.61, 11.43, 20}};
+
 //! @ref https://tetris.wiki/Scoring#Original_Nintendo_scoring_system
-class NintendoClassicScore : public IScore {
+class NintendoClassicScore final : public IScore {
   int score{};
   int nb_lines{};
   int compteted_lines{};
@@ -21,6 +27,9 @@ class NintendoClassicScore : public IScore {
 
   void OnSoftDrop() override { score++; };
 
+  //! not in the original game, guideline value
+  void OnHardDrop(int nb_cells) override { score += 2 * nb_cells; };
+
   int Score() const override { return score; };
 
   int Level() const override { return 1 + compteted_lines / 10; };
@@ -28,6 +37,9 @@ class NintendoClassicScore : public IScore {
   int CompletedLines() const override { return compteted_lines; };
 
   std::chrono::milliseconds DropPeriod(int level = 0) const override;
+
+  //! frame exact, DropPeriod truncates to milliseconds
+  Gravity GravityPerFrame(int level = 0) const override;
 };
 
 }  // namespace tetris
\ No newline at end of file
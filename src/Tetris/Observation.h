@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "Tetris/Tetris.h"
+#include "Tetris/TetrisBatch.h"
+
+namespace tetris {
+
+enum class eObservationFormat {
+  Bytes,  //!< a byte per value, 0 or 1
+  Bits,   //!< 8 values per byte, first value in the lowest bit
+};
+
+//! dense state for learning agents, in order:
+//! - occupancy of the stale blocks, height x width, row after row
+//! - occupancy of the current tetriminos, height x width
+//! - one hot of the current tetriminos type
+//! - one hot of each previewed tetriminos type
+struct ObservationLayout {
+  static constexpr int kTypeCount = static_cast<int>(Tetriminos::eType::Count);
+
+  int width{};
+  int height{};
+  int preview{};
+
+  size_t Values() const {
+    return 2 * static_cast<size_t>(width) * height + kTypeCount * (1 + static_cast<size_t>(preview));
+  }
+  //! buffer size in bytes
+  size_t Size(eObservationFormat format) const {
+    return format == eObservationFormat::Bytes ? Values() : (Values() + 7) / 8;
+  }
+};
+
+namespace detail {
+
+class ObservationWriter {
+ public:
+  ObservationWriter(uint8_t* out_p, eObservationFormat format_p) : out(out_p), format(format_p) {}
+
+  void Put(bool value) {
+    if (format == eObservationFormat::Bytes) {
+      *out++ = value;
+      return;
+    }
+    bits = static_cast<uint8_t>(bits | (value << nb_bits));
+    if (++nb_bits == 8)
+      Flush();
+  }
+  void PutRow(uint64_t row, int width) {
+    for (int x = 0; x < width; x++)
+      Put((row >> x) & 1);
+  }
+  void PutOneHot(int index, int count) {
+    for (int i = 0; i < count; i++)
+      Put(i == index);
+  }
+  //! write the last partial byte
+  void Finish() {
+    if (nb_bits)
+      Flush();
+  }
+
+ private:
+  void Flush() {
+    *out++ = bits;
+    bits = 0;
+    nb_bits = 0;
+  }
+
+  uint8_t* out;
+  eObservationFormat format;
+  uint8_t bits{};
+  int nb_bits{};
+};
+
+//! @param row(y) occupancy bits of stale blocks row y
+//! @param next(offset) type of the previewed tetriminos
+template <class RowFn, class NextFn>
+void WriteObservation(const ObservationLayout& layout,
+                      eObservationFormat format,
+                      RowFn row,
+                      const Tetriminos& current,
+                      NextFn next,
+                      uint8_t* out) {
+  ObservationWriter writer(out, format);
+  for (int y = 0; y < layout.height; y++)
+    writer.PutRow(row(y), layout.width);
+
+  // current tetriminos spans 4 rows at most, as masks from its top row
+  const auto blocks = current.BlocksAbsolutePosition();
+  const int top = current.Position().y + current.BlocksBounds().top;
+  std::array<uint64_t, 4> current_rows{};
+  for (const Pos& pos : blocks)
+    current_rows[pos.y - top] |= uint64_t{1} << pos.x;
+  for (int y = 0; y < layout.height; y++) {
+    const bool in_piece = y >= top && y < top + 4;
+    writer.PutRow(in_piece ? current_rows[y - top] : 0, layout.width);
+  }
+
+  writer.PutOneHot(static_cast<int>(current.Type()), ObservationLayout::kTypeCount);
+  for (int offset = 0; offset < layout.preview; offset++)
+    writer.PutOneHot(static_cast<int>(next(offset)), ObservationLayout::kTypeCount);
+  writer.Finish();
+}
+
+}  // namespace detail
+
+template <class Traits>
+ObservationLayout LayoutOf(const BasicTetris<Traits>& game, int preview) {
+  return ObservationLayout{game.Width(), game.Height(), preview};
+}
+
+inline ObservationLayout LayoutOf(const TetrisBatch& batch) {
+  return ObservationLayout{batch.Width(), batch.Height(), batch.Preview()};
+}
+
+//! write the observation of @param game in one pass
+//!@param preview number of next tetriminos, at most the engine buffer depth
+//!@param out LayoutOf(game, preview).Size(format) bytes owned by the caller
+template <class Traits>
+void WriteObservation(const BasicTetris<Traits>& game,
+                      int preview,
+                      eObservationFormat format,
+                      uint8_t* out) {
+  const auto& board = game.Playfield();
+  detail::WriteObservation(
+      LayoutOf(game, preview), format, [&board](int y) { return board.RowMask(y); },
+      game.Current(), [&game](int offset) { return game.Next(offset).Type(); }, out);
+}
+
+//! write the observation of game @param index of @param batch in one pass
+//!@param out LayoutOf(batch).Size(format) bytes owned by the caller
+inline void WriteObservation(const TetrisBatch& batch,
+                             int index,
+                             eObservationFormat format,
+                             uint8_t* out) {
+  detail::WriteObservation(
+      LayoutOf(batch), format, [&batch, index](int y) { return batch.RowMask(index, y); },
+      batch.Current(index), [&batch, index](int offset) { return batch.Next(index, offset); },
+      out);
+}
+
+}  // namespace tetris
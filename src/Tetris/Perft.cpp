@@ -0,0 +1,149 @@
+#include "Perft.h"
+#include <algorithm>
+#include <array>
+#include "Tetris/TetrisImpl.h"
+
+namespace tetris {
+
+template class BasicTetris<PerftTraits>;
+
+namespace {
+
+//! poses are searched in a box a few cells larger than the playfield
+constexpr int kMargin = 4;
+
+//! exact key of the cells covered by @param t
+uint64_t CellsOf(const Tetriminos& t) {
+  std::array<uint64_t, 4> cells{};
+  const auto blocks = t.BlocksAbsolutePosition();
+  for (size_t i = 0; i < blocks.size() && i < cells.size(); i++)
+    cells[i] = static_cast<uint64_t>((blocks[i].y + 2 * kMargin) * 128 + blocks[i].x + kMargin);
+  std::sort(cells.begin(), cells.end());
+  return cells[0] | cells[1] << 14 | cells[2] << 28 | cells[3] << 42;
+}
+
+}  // namespace
+
+Perft::Perft(uint32_t seed, BoardSize board_size, int preview)
+    : generator(seed), game(user_input, timer, score, generator, preview, board_size) {
+  static_cast<InputListener&>(game).OnResume();
+  visited.resize(static_cast<size_t>(board_size.width + 2 * kMargin) *
+                 (board_size.height + 2 * kMargin) * 4);
+}
+
+void Perft::Save(Snapshot& snapshot) const {
+  game.SaveState(snapshot.game);
+  snapshot.score = score;
+  snapshot.generator = generator;
+}
+
+void Perft::Load(const Snapshot& snapshot) {
+  game.LoadState(snapshot.game);
+  score = snapshot.score;
+  generator = snapshot.generator;
+}
+
+void Perft::Place(const Tetriminos& placement) {
+  game.SetPose(placement);
+  static_cast<InputListener&>(game).OnHardDrop();
+}
+
+std::vector<Tetriminos> Perft::Placements() {
+  std::vector<Tetriminos> placements;
+  Save(root);
+  Generate(placements);
+  Load(root);
+  return placements;
+}
+
+uint64_t Perft::Count(int depth) {
+  if (snapshots.size() <= static_cast<size_t>(depth)) {
+    snapshots.resize(depth + 1);
+    children.resize(depth + 1);
+  }
+  // the search moves the game: history, lock countdown
+  Save(root);
+  const uint64_t count = CountFrom(depth);
+  Load(root);
+  return count;
+}
+
+uint64_t Perft::CountFrom(int depth) {
+  if (depth == 0)
+    return 1;
+  if (game.IsOver())
+    return 0;
+
+  auto& placements = children[depth];
+  placements.clear();
+  Generate(placements);
+  if (depth == 1)
+    return placements.size();  // leaves are counted, not played
+
+  Snapshot& snapshot = snapshots[depth];
+  Save(snapshot);
+  uint64_t count = 0;
+  for (const Tetriminos& placement : placements) {
+    Place(placement);
+    count += CountFrom(depth - 1);
+    Load(snapshot);
+  }
+  return count;
+}
+
+void Perft::Generate(std::vector<Tetriminos>& placements) {
+  if (game.IsOver())
+    return;
+  if (++stamp == 0) {
+    std::fill(visited.begin(), visited.end(), 0);
+    stamp = 1;
+  }
+  const int width = game.Width() + 2 * kMargin;
+  const int height = game.Height() + 2 * kMargin;
+  const auto visit = [&](const Tetriminos& t) {
+    const Pos pos = t.Position();
+    const int x = pos.x + kMargin;
+    const int y = pos.y + kMargin;
+    if (x < 0 || x >= width || y < 0 || y >= height)
+      return;  // lifted far above the playfield, only when the game is over
+    uint32_t& seen = visited[(static_cast<size_t>(y) * width + x) * 4 + t.Rotation()];
+    if (seen != stamp) {
+      seen = stamp;
+      queue.push_back(t);
+    }
+  };
+
+  const Tetriminos spawn = game.Current();
+  queue.clear();
+  placed.clear();
+  visit(spawn);
+
+  InputListener& input = game;
+  using Move = void (InputListener::*)();
+  static constexpr Move kMoves[] = {&InputListener::OnLeft, &InputListener::OnRight,
+                                    &InputListener::OnRotate, &InputListener::OnReverseRotate};
+  for (size_t i = 0; i < queue.size(); i++) {
+    const Tetriminos pose = queue[i];
+    game.SetPose(pose);
+    if (game.DropDistance() == 0) {
+      const uint64_t cells = CellsOf(pose);
+      if (std::find(placed.begin(), placed.end(), cells) == placed.end()) {
+        placed.push_back(cells);
+        placements.push_back(pose);
+      }
+    } else {
+      game.Down();
+      moves++;
+      visit(game.Current());
+    }
+    for (Move move : kMoves) {
+      game.SetPose(pose);
+      (input.*move)();
+      moves++;
+      visit(game.Current());
+    }
+  }
+  game.SetPose(spawn);
+}
+
+}  // namespace tetris
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Tetris/NintendoClassicScore.h"
+#include "Tetris/Tetris.h"
+#include "Tetris/VirtualTimer.h"
+
+namespace tetris {
+
+//! deterministic generator with a 4 bytes state, saved at each node of a search
+struct SeededGenerator final : ITetriminosGenerator {
+  explicit SeededGenerator(uint32_t seed) : state(seed) {}
+  Tetriminos Create() override {
+    state = state * 1664525u + 1013904223u;
+    return Tetriminos{static_cast<Tetriminos::eType>((state >> 16) % 7)};
+  }
+
+  uint32_t state;
+};
+
+struct PerftTraits : DefaultTraits {
+  using Score = NintendoClassicScore;
+  using Timer = VirtualTimer;
+  using Generator = SeededGenerator;
+};
+
+extern template class BasicTetris<PerftTraits>;
+
+//! engine of Perft, the current tetriminos can be put at any pose to try the moves from it
+class PerftTetris : public BasicTetris<PerftTraits> {
+ public:
+  using BasicTetris::BasicTetris;
+  void SetPose(const Tetriminos& t) { MoveCurrent(t); }
+};
+
+//! perft, as for chess move generators: counts the distinct placement sequences of the
+//! next tetriminos. Placements are found with the moves of the engine (left, right,
+//! rotations and down) from the spawn pose, tucks and spins included, and are distinct by
+//! the cells they cover. Counts of a seed are golden values for collisions and rotations
+class Perft {
+ public:
+  //!@param seed of the tetriminos sequence
+  explicit Perft(uint32_t seed, BoardSize board_size = BoardSize{}, int preview = 1);
+
+  //! number of placement sequences of @param depth tetriminos, a game over ends a sequence.
+  //! the game is left as it was
+  uint64_t Count(int depth);
+
+  //! poses where the current tetriminos locks, one per set of cells
+  std::vector<Tetriminos> Placements();
+
+  //! lock the current tetriminos at @param placement, to set a position up
+  void Place(const Tetriminos& placement);
+
+  PerftTetris& Game() { return game; }
+  //! engine moves tried by the Count() calls
+  uint64_t Moves() const { return moves; }
+
+ private:
+  struct Snapshot {
+    PerftTetris::State game;
+    NintendoClassicScore score;
+    SeededGenerator generator{0};
+  };
+
+  void Save(Snapshot& snapshot) const;
+  void Load(const Snapshot& snapshot);
+  uint64_t CountFrom(int depth);
+  void Generate(std::vector<Tetriminos>& placements);
+
+  UserInput user_input;
+  VirtualTimer timer;
+  NintendoClassicScore score;
+  SeededGenerator generator;
+  PerftTetris game;
+
+  uint64_t moves{};
+  Snapshot root;                                  //!< game restored after a search
+  std::vector<Snapshot> snapshots;                //!< one per depth
+  std::vector<std::vector<Tetriminos>> children;  //!< placements, one list per depth
+  std::vector<Tetriminos> queue;
+  std::vector<uint32_t> visited;  //!< search stamp of each pose
+  uint32_t stamp{};
+  std::vector<uint64_t> placed;   //!< cells of the placements of a search
+};
+
+}  // namespace tetris
@@ -3,7 +3,7 @@
 #include <thread>
 namespace tetris {
 
-struct PollingTimer : public ITimer {
+struct PollingTimer final : public ITimer {
   void Start(const std::chrono::milliseconds& period_p) {
     begin = std::chrono::steady_clock::now();
     period = period_p;
@@ -0,0 +1,104 @@
+#include "Rasterizer.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+constexpr Rasterizer::Rgba kPanel{32, 32, 44, 255};
+
+//! ghost cells are the tetriminos color at a quarter over the background
+Rasterizer::Rgba Dim(const Rasterizer::Rgba& rgba) {
+  Rasterizer::Rgba dim{};
+  for (size_t i = 0; i < 3; i++)
+    dim[i] = static_cast<uint8_t>((rgba[i] + 3 * Rasterizer::kBackground[i]) / 4);
+  dim[3] = 255;
+  return dim;
+}
+
+}  // namespace
+
+Rasterizer::Rasterizer(BoardSize board_size, int preview_p, int cell_p)
+    : columns(board_size.width + kPanelCells),
+      rows(std::max(board_size.height, preview_p * kPreviewCells + 1)),
+      preview(preview_p),
+      cell(cell_p),
+      width(columns * cell_p),
+      height(rows * cell_p) {
+  if (cell < 2 || preview < 0)
+    throw std::runtime_error("invalid rasterizer cell size or preview");
+  background.resize(static_cast<size_t>(width) * height * 4);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const Rgba& rgba = x < board_size.width * cell ? kBackground : kPanel;
+      std::copy(rgba.begin(), rgba.end(), background.begin() + (y * width + x) * 4);
+    }
+  }
+  pixels = background;
+}
+
+Rasterizer::Rgba Rasterizer::ColorOf(Tetriminos::eColor color) {
+  static constexpr Rgba kColors[] = {
+      {0, 240, 240, 255},    // Cyan
+      {240, 240, 0, 255},    // Yellow
+      {160, 0, 240, 255},    // Purple
+      {240, 160, 0, 255},    // Orange
+      {0, 0, 240, 255},      // Blue
+      {240, 0, 0, 255},      // Red
+      {0, 240, 0, 255},      // Green
+      {128, 128, 128, 255},  // Gray
+  };
+  const auto i = static_cast<size_t>(color);
+  return i < std::size(kColors) ? kColors[i] : kBackground;
+}
+
+const std::vector<uint8_t>& Rasterizer::Render(const SpectatorState& state) {
+  pixels = background;
+  for (int y = 0; y < state.height; y++) {
+    for (uint64_t row = state.rows[y]; row; row &= row - 1) {
+      const int x = CountTrailingZeros(row);
+      Fill(x, y, ColorOf(state.colors[y * state.width + x]));
+    }
+  }
+  Ghost(state.current, state.DropDistance());
+  Piece(state.current, ColorOf(state.current.ColorHint()));
+  for (int slot = 0; slot < preview && slot < static_cast<int>(state.next.size()); slot++)
+    Preview(slot, state.next[slot]);
+  return pixels;
+}
+
+void Rasterizer::Fill(int x, int y, const Rgba& rgba) {
+  if (x < 0 || x >= columns || y < 0 || y >= rows)
+    return;
+  // the last row and column of the cell are left to the background, as a grid
+  const size_t stride = static_cast<size_t>(width) * 4;
+  uint8_t* first = pixels.data() + static_cast<size_t>(y) * cell * stride + x * cell * 4;
+  for (int i = 0; i < cell - 1; i++)
+    std::copy(rgba.begin(), rgba.end(), first + i * 4);
+  for (int j = 1; j < cell - 1; j++)
+    std::copy_n(first, (cell - 1) * 4, first + j * stride);
+}
+
+void Rasterizer::Piece(const Tetriminos& t, const Rgba& rgba) {
+  for (const Pos& p : t.BlocksAbsolutePosition())
+    Fill(p.x, p.y, rgba);
+}
+
+void Rasterizer::Ghost(const Tetriminos& t, int drop) {
+  if (drop == 0)
+    return;
+  Tetriminos ghost = t;
+  ghost.SetY(t.Position().y + drop);
+  Piece(ghost, Dim(ColorOf(t.ColorHint())));
+}
+
+void Rasterizer::Preview(int slot, Tetriminos::eType type) {
+  Tetriminos next{type};
+  next.SetX(columns - kPanelCells + 2);
+  next.SetY(slot * kPreviewCells + 2);
+  Piece(next, ColorOf(next.ColorHint()));
+}
+
+}  // namespace tetris
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Tetris/SpectatorStream.h"
+#include "Tetris/Tetris.h"
+
+namespace tetris {
+
+//! offscreen software rendering of a game into an RGBA image, for thumbnails and videos.
+//! The playfield is on the left, the preview queue on the right. The image buffer is
+//! allocated once, each Render() draws over the background layout, cell after cell
+class Rasterizer {
+ public:
+  static constexpr int kPanelCells = 6;    //!< width of the preview panel, in cells
+  static constexpr int kPreviewCells = 3;  //!< height of a preview slot, in cells
+
+  using Rgba = std::array<uint8_t, 4>;
+
+  //!@param preview number of next tetriminos shown
+  //!@param cell side of a cell in pixels, a 1 pixel grid line included
+  explicit Rasterizer(BoardSize board_size, int preview = 1, int cell = 8);
+
+  //! render @param game, its stale blocks, current and ghost tetriminos and preview
+  template <class Traits>
+  const std::vector<uint8_t>& Render(const BasicTetris<Traits>& game);
+  //! render a game seen by a spectator, i.e. a recorded spectator stream being decoded
+  const std::vector<uint8_t>& Render(const SpectatorState& state);
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+  //! RGBA, row after row from the top
+  const std::vector<uint8_t>& Pixels() const { return pixels; }
+
+  static Rgba ColorOf(Tetriminos::eColor color);
+  static constexpr Rgba kBackground{16, 16, 24, 255};
+
+ private:
+  //! paint the playfield cell (x,y), cells out of the image are clipped
+  void Fill(int x, int y, const Rgba& rgba);
+  void Piece(const Tetriminos& t, const Rgba& rgba);
+  void Ghost(const Tetriminos& t, int drop);
+  void Preview(int slot, Tetriminos::eType type);
+
+  int columns;  //!< in cells
+  int rows;
+  int preview;
+  int cell;
+  int width;  //!< in pixels
+  int height;
+  std::vector<uint8_t> background;  //!< static layout
+  std::vector<uint8_t> pixels;
+};
+
+template <class Traits>
+const std::vector<uint8_t>& Rasterizer::Render(const BasicTetris<Traits>& game) {
+  pixels = background;
+  game.Playfield().ForEachBlock(
+      [this](const Pos& pos, Tetriminos::eColor color) { Fill(pos.x, pos.y, ColorOf(color)); });
+  Ghost(game.Current(), game.DropDistance());
+  Piece(game.Current(), ColorOf(game.Current().ColorHint()));
+  for (int slot = 0; slot < preview; slot++)
+    Preview(slot, game.Next(slot).Type());
+  return pixels;
+}
+
+}  // namespace tetris
@@ -0,0 +1,164 @@
+#include "RollbackSession.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+//! gives the keys of a frame to the engine, pause and resume are not game inputs
+struct FrameKeys : UserInput {
+  void Press(FrameInput input) {
+    for (int key = 0; key < static_cast<int>(eInputKey::Pause); key++) {
+      if (input >> key & 1)
+        Fire(static_cast<eInputKey>(key));
+    }
+  }
+};
+
+}  // namespace
+
+struct RollbackSession::Player {
+  struct Slot {
+    int64_t frame{-1};
+    FrameInput input{};
+  };
+  struct Snapshot {
+    HeadlessTetris::State game;
+    NintendoClassicScore score;
+    TetriminosGenerator generator{0};
+  };
+
+  Player(const Config& config, int window)
+      : generator(config.seed),
+        game(keys, timer, score, generator, config.preview, config.board_size),
+        inputs(2 * window),
+        saved(window) {
+    static_cast<InputListener&>(game).OnResume();
+  }
+
+  bool Known(int64_t f) const { return inputs[f % inputs.size()].frame == f; }
+  FrameInput Input(int64_t f) const { return Known(f) ? inputs[f % inputs.size()].input : 0; }
+  void Store(int64_t f, FrameInput input) {
+    inputs[f % inputs.size()] = Slot{f, input};
+    while (Known(confirmed))
+      confirmed++;
+  }
+
+  void Save(int64_t f) {
+    Snapshot& snapshot = saved[f % saved.size()];
+    game.SaveState(snapshot.game);
+    snapshot.score = score;
+    snapshot.generator = generator;
+  }
+  void Load(int64_t f) {
+    const Snapshot& snapshot = saved[f % saved.size()];
+    game.LoadState(snapshot.game);
+    score = snapshot.score;
+    generator = snapshot.generator;
+  }
+
+  FrameKeys keys;
+  VirtualTimer timer;  //!< never advanced, frames are run by the session
+  NintendoClassicScore score;
+  TetriminosGenerator generator;
+  HeadlessTetris game;
+  std::vector<Slot> inputs;  //!< ring indexed by frame, covers remote peers running ahead
+  int64_t confirmed{};       //!< first frame whose input is unknown
+  std::vector<Snapshot> saved;  //!< ring indexed by frame, games before the frame
+};
+
+RollbackSession::RollbackSession(const Config& config)
+    : local(config.local_player), max_rollback(config.max_rollback) {
+  if (config.players < 1 || local < 0 || local >= config.players)
+    throw std::runtime_error("local player is out of the session");
+  if (max_rollback < 1)
+    throw std::runtime_error("max rollback must be positive");
+  for (int i = 0; i < config.players; i++)
+    players.push_back(std::make_unique<Player>(config, max_rollback));
+}
+
+RollbackSession::~RollbackSession() = default;
+
+RollbackSession::Player& RollbackSession::At(int player) const {
+  if (player < 0 || player >= Players())
+    throw std::runtime_error("player is out of the session");
+  return *players[player];
+}
+
+const HeadlessTetris& RollbackSession::Game(int player) const {
+  return At(player).game;
+}
+
+FrameInput RollbackSession::Input(int player, int64_t f) const {
+  return At(player).Input(f);
+}
+
+int64_t RollbackSession::ConfirmedFrame() const {
+  int64_t confirmed = frame;
+  for (const auto& player : players)
+    confirmed = std::min(confirmed, player->confirmed);
+  return confirmed;
+}
+
+bool RollbackSession::AdvanceFrame(FrameInput input) {
+  Rollback();
+  if (frame - ConfirmedFrame() >= max_rollback) {
+    stats.stalls++;
+    return false;
+  }
+  At(local).Store(frame, input);
+  RunFrame(frame++);
+  stats.frames++;
+  return true;
+}
+
+void RollbackSession::AddRemoteInput(int player, int64_t f, FrameInput input) {
+  Player& remote = At(player);
+  if (player == local)
+    throw std::runtime_error("local inputs are given to AdvanceFrame");
+  if (f < 0 || f >= frame + max_rollback)
+    throw std::runtime_error("remote input is out of the rollback window");
+  if (f < remote.confirmed || remote.Known(f))
+    return;  // sent again by the peer
+
+  remote.Store(f, input);
+  if (f < frame && input != 0)  // predicted as no key
+    rollback_to = std::min(rollback_to, f);
+}
+
+void RollbackSession::Rollback() {
+  if (rollback_to >= frame) {
+    rollback_to = std::numeric_limits<int64_t>::max();
+    return;
+  }
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto& player : players)
+    player->Load(rollback_to);
+  for (int64_t f = rollback_to; f < frame; f++)
+    RunFrame(f);
+
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  const int64_t depth = frame - rollback_to;
+  stats.rollbacks++;
+  stats.resimulated_frames += static_cast<uint64_t>(depth);
+  stats.max_depth = std::max(stats.max_depth, depth);
+  auto& timing = stats.resimulation;
+  timing.calls++;
+  timing.total += elapsed;
+  timing.min = std::min<std::chrono::nanoseconds>(timing.min, elapsed);
+  timing.max = std::max<std::chrono::nanoseconds>(timing.max, elapsed);
+  rollback_to = std::numeric_limits<int64_t>::max();
+}
+
+void RollbackSession::RunFrame(int64_t f) {
+  for (auto& player : players) {
+    player->Save(f);
+    if (player->game.IsOver())
+      continue;
+    player->keys.Press(player->Input(f));
+    player->game.AdvanceFrames(1);
+  }
+}
+
+}  // namespace tetris
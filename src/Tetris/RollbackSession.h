@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Tetris/EngineStats.h"
+#include "Tetris/HeadlessTetris.h"
+
+namespace tetris {
+
+//! keys pressed by a player during a frame, bit n is eInputKey n
+using FrameInput = uint8_t;
+
+constexpr FrameInput InputOf(eInputKey key) {
+  return static_cast<FrameInput>(1 << static_cast<int>(key));
+}
+
+struct RollbackStats {
+  uint64_t frames{};              //!< run by AdvanceFrame()
+  uint64_t stalls{};              //!< AdvanceFrame() waiting for remote inputs
+  uint64_t rollbacks{};           //!< mispredictions corrected
+  uint64_t resimulated_frames{};  //!< total of the rollbacks
+  int64_t max_depth{};            //!< most frames resimulated by a rollback
+  OperationTiming resimulation;   //!< time of each rollback
+};
+
+//! rollback netcode of a versus: every peer runs the frame driven games of all players,
+//! predicting the inputs of the remote players it did not receive yet. When an input
+//! arrives late and differs from the prediction, the games are loaded back to that frame
+//! and run again with the corrected inputs. Games are deterministic: same seed, same
+//! inputs, same frames give the same games on every peer.
+//!
+//! the local player runs at most max_rollback frames ahead of the slowest remote input,
+//! so a rollback never resimulates more than max_rollback frames
+class RollbackSession {
+ public:
+  struct Config {
+    int players{2};
+    int local_player{0};
+    int max_rollback{8};  //!< frames
+    int seed{};           //!< of the generators, the same for every player
+    BoardSize board_size{Board::DefaultSize()};
+    int preview{3};
+  };
+
+  explicit RollbackSession(const Config& config);
+  ~RollbackSession();
+  RollbackSession(const RollbackSession&) = delete;
+  RollbackSession& operator=(const RollbackSession&) = delete;
+
+  //! run the next frame with @param local input, missing remote inputs are predicted
+  //! as no key pressed
+  //!@return false, nothing done, when remote inputs are max_rollback frames late
+  bool AdvanceFrame(FrameInput local);
+
+  //! input of remote @param player for @param frame, in any order, duplicates ignored
+  //! a misprediction is corrected by the next AdvanceFrame() or Rollback()
+  void AddRemoteInput(int player, int64_t frame, FrameInput input);
+
+  //! run again the frames since the first misprediction
+  void Rollback();
+
+  //! next frame to run
+  int64_t Frame() const { return frame; }
+  //! inputs of every player are known for the frames before
+  int64_t ConfirmedFrame() const;
+  //! input of @param player at @param frame, the prediction when not received
+  //!@pre frame in [Frame() - max_rollback, Frame()), what the local peer sends
+  FrameInput Input(int player, int64_t frame) const;
+
+  int Players() const { return static_cast<int>(players.size()); }
+  int MaxRollback() const { return max_rollback; }
+  //! game of @param player at Frame(), with predictions
+  const HeadlessTetris& Game(int player) const;
+  const RollbackStats& Stats() const { return stats; }
+
+ private:
+  struct Player;
+
+  Player& At(int player) const;
+  //! save the games before @param f and run it
+  void RunFrame(int64_t f);
+
+  int local;
+  int max_rollback;
+  std::vector<std::unique_ptr<Player>> players;
+  int64_t frame{};
+  int64_t rollback_to{std::numeric_limits<int64_t>::max()};
+  RollbackStats stats;
+};
+
+}  // namespace tetris
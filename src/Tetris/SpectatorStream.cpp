@@ -0,0 +1,302 @@
+#include "SpectatorStream.h"
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+//! high nibble of the first byte of a message, the low nibble is an argument
+enum class eOp : uint8_t {
+  Keyframe = 1,
+  Pose,   //!< rotation | dx, dy
+  Lock,   //!< incoming type | drop
+  Score,  //!< 0 | zigzag varint delta
+  Level,  //!< 0 | varint level
+};
+
+void PutOp(eOp op, int arg, std::vector<uint8_t>& out) {
+  out.push_back(static_cast<uint8_t>(static_cast<int>(op) << 4 | arg));
+}
+
+void PutVarint(uint64_t value, std::vector<uint8_t>& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class Reader {
+ public:
+  Reader(const uint8_t* data_p, size_t size_p) : data(data_p), size(size_p) {}
+
+  bool AtEnd() const { return pos == size; }
+  uint8_t Byte() {
+    if (pos == size)
+      throw std::runtime_error("truncated spectator message");
+    return data[pos++];
+  }
+  int Signed() { return static_cast<int8_t>(Byte()); }
+  uint64_t Varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const uint8_t byte = Byte();
+      value |= uint64_t{byte & 0x7fu} << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    throw std::runtime_error("invalid varint in spectator message");
+  }
+  Tetriminos::eType Type(int value) {
+    if (value >= static_cast<int>(Tetriminos::eType::Count))
+      throw std::runtime_error("invalid tetriminos type in spectator message");
+    return static_cast<Tetriminos::eType>(value);
+  }
+
+ private:
+  const uint8_t* data;
+  size_t size;
+  size_t pos{};
+};
+
+void SetPose(Tetriminos& t, int rotation, Pos pos) {
+  while (t.Rotation() != rotation)
+    t.Rotate();
+  t.SetX(pos.x);
+  t.SetY(pos.y);
+}
+
+SpectatorState DecodeKeyframe(Reader& in) {
+  SpectatorState state;
+  state.width = in.Byte();
+  state.height = in.Byte();
+  const int preview = in.Byte();
+  if (state.width < 1 || state.width > 64 || state.height < 1 || state.height > 64)
+    throw std::runtime_error("invalid board size in spectator message");
+
+  const int row_bytes = (state.width + 7) / 8;
+  for (int y = 0; y < state.height; y++) {
+    uint64_t row = 0;
+    for (int i = 0; i < row_bytes; i++)
+      row |= uint64_t{in.Byte()} << (8 * i);
+    state.rows.push_back(row & LowBits(state.width));
+  }
+
+  state.colors.resize(static_cast<size_t>(state.width) * state.height);
+  int nibble = 0;
+  uint8_t byte = 0;
+  for (int y = 0; y < state.height; y++) {
+    for (uint64_t bits = state.rows[y]; bits; bits &= bits - 1) {
+      if (nibble++ % 2 == 0)
+        byte = in.Byte();
+      const int color = nibble % 2 ? byte & 0xf : byte >> 4;
+      if (color >= static_cast<int>(Tetriminos::eColor::Count))
+        throw std::runtime_error("invalid color in spectator message");
+      state.colors[y * state.width + CountTrailingZeros(bits)] =
+          static_cast<Tetriminos::eColor>(color);
+    }
+  }
+
+  const uint8_t current = in.Byte();
+  state.current = Tetriminos{in.Type(current & 0xf)};
+  const int x = in.Signed();
+  const int y = in.Signed();
+  SetPose(state.current, (current >> 4) & 3, Pos{x, y});
+  for (int i = 0; i < preview; i++)
+    state.next.push_back(in.Type(in.Byte()));
+  state.score = static_cast<int>(UnZigZag(in.Varint()));
+  state.lines = static_cast<int>(in.Varint());
+  state.level = static_cast<int>(in.Varint());
+  return state;
+}
+
+}  // namespace
+
+bool SpectatorState::operator==(const SpectatorState& other) const {
+  if (width != other.width || height != other.height || rows != other.rows ||
+      next != other.next || score != other.score || lines != other.lines ||
+      level != other.level)
+    return false;
+  if (current.Type() != other.current.Type() || current.Rotation() != other.current.Rotation() ||
+      !(current.Position() == other.current.Position()))
+    return false;
+  for (int y = 0; y < height; y++) {
+    for (uint64_t bits = rows[y]; bits; bits &= bits - 1) {
+      const int cell = y * width + CountTrailingZeros(bits);
+      if (colors[cell] != other.colors[cell])
+        return false;
+    }
+  }
+  return true;
+}
+
+int SpectatorState::DropDistance() const {
+  const auto fits = [this](int dy) {
+    for (const Pos& pos : current.BlocksAbsolutePosition()) {
+      const int y = pos.y + dy;
+      if (y >= height || (y >= 0 && ((rows[y] >> pos.x) & 1)))
+        return false;
+    }
+    return true;
+  };
+  int distance = 0;
+  while (fits(distance + 1))
+    distance++;
+  return distance;
+}
+
+void SpectatorState::Lock(int drop, Tetriminos::eType incoming) {
+  current.SetY(current.Position().y + drop);
+  const auto color = current.ColorHint();
+  for (const Pos& pos : current.BlocksAbsolutePosition()) {
+    if (pos.y < 0 || pos.y >= height || pos.x < 0 || pos.x >= width)
+      continue;  // above ceil, game is over anyway
+    rows[pos.y] |= uint64_t{1} << pos.x;
+    colors[pos.y * width + pos.x] = color;
+  }
+
+  // full rows are removed, rows above fall
+  const uint64_t full = LowBits(width);
+  int dst = height - 1;
+  for (int src = height - 1; src >= 0; src--) {
+    if (rows[src] == full) {
+      lines++;
+      continue;
+    }
+    if (dst != src) {
+      rows[dst] = rows[src];
+      std::copy_n(colors.begin() + src * width, width, colors.begin() + dst * width);
+    }
+    dst--;
+  }
+  for (; dst >= 0; dst--)
+    rows[dst] = 0;
+
+  next.push_back(incoming);
+  current = Tetriminos{next.front()};
+  next.erase(next.begin());
+  current.SetX(width / 2);
+}
+
+void detail::EncodeKeyframe(const SpectatorState& state, std::vector<uint8_t>& out) {
+  PutOp(eOp::Keyframe, 0, out);
+  out.push_back(static_cast<uint8_t>(state.width));
+  out.push_back(static_cast<uint8_t>(state.height));
+  out.push_back(static_cast<uint8_t>(state.next.size()));
+
+  const int row_bytes = (state.width + 7) / 8;
+  for (uint64_t row : state.rows) {
+    for (int i = 0; i < row_bytes; i++)
+      out.push_back(static_cast<uint8_t>(row >> (8 * i)));
+  }
+
+  int nibble = 0;
+  for (int y = 0; y < state.height; y++) {
+    for (uint64_t bits = state.rows[y]; bits; bits &= bits - 1) {
+      const auto color =
+          static_cast<uint8_t>(state.colors[y * state.width + CountTrailingZeros(bits)]);
+      if (nibble++ % 2 == 0)
+        out.push_back(color);
+      else
+        out.back() = static_cast<uint8_t>(out.back() | color << 4);
+    }
+  }
+
+  const auto& current = state.current;
+  out.push_back(static_cast<uint8_t>(static_cast<int>(current.Type()) | current.Rotation() << 4));
+  out.push_back(static_cast<uint8_t>(current.Position().x));
+  out.push_back(static_cast<uint8_t>(current.Position().y));
+  for (auto type : state.next)
+    out.push_back(static_cast<uint8_t>(type));
+  PutVarint(ZigZag(state.score), out);
+  PutVarint(static_cast<uint64_t>(state.lines), out);
+  PutVarint(static_cast<uint64_t>(state.level), out);
+}
+
+DeltaEncoder::DeltaEncoder(int preview_p, int keyframe_interval_p)
+    : preview(preview_p),
+      keyframe_interval(keyframe_interval_p),
+      since_keyframe(keyframe_interval_p) {
+  if (preview < 0 || preview > 15)
+    throw std::runtime_error("spectator preview must be in [0,15]");
+  if (keyframe_interval < 1)
+    throw std::runtime_error("keyframe interval must be positive");
+}
+
+void DeltaEncoder::EncodeLock(int drop, Tetriminos::eType incoming, std::vector<uint8_t>& out) {
+  PutOp(eOp::Lock, static_cast<int>(incoming), out);
+  out.push_back(static_cast<uint8_t>(drop));
+  shadow.Lock(drop, incoming);
+}
+
+void DeltaEncoder::EncodeChanges(const Tetriminos& current,
+                                 int score,
+                                 int level,
+                                 std::vector<uint8_t>& out) {
+  const Pos from = shadow.current.Position();
+  const Pos to = current.Position();
+  if (!(from == to) || shadow.current.Rotation() != current.Rotation()) {
+    PutOp(eOp::Pose, current.Rotation(), out);
+    out.push_back(static_cast<uint8_t>(to.x - from.x));
+    out.push_back(static_cast<uint8_t>(to.y - from.y));
+    shadow.current = current;
+  }
+  if (score != shadow.score) {
+    PutOp(eOp::Score, 0, out);
+    PutVarint(ZigZag(int64_t{score} - shadow.score), out);
+    shadow.score = score;
+  }
+  if (level != shadow.level) {
+    PutOp(eOp::Level, 0, out);
+    PutVarint(static_cast<uint64_t>(level), out);
+    shadow.level = level;
+  }
+}
+
+void DeltaDecoder::Decode(const uint8_t* data, size_t size) {
+  Reader in(data, size);
+  while (!in.AtEnd()) {
+    const uint8_t header = in.Byte();
+    const auto op = static_cast<eOp>(header >> 4);
+    const int arg = header & 0xf;
+
+    if (op == eOp::Keyframe) {
+      state = DecodeKeyframe(in);
+      synchronized = true;
+      continue;
+    }
+    if (!synchronized)
+      throw std::runtime_error("spectator stream must start with a keyframe");
+
+    switch (op) {
+      case eOp::Pose: {
+        const Pos from = state.current.Position();
+        const int dx = in.Signed();
+        const int dy = in.Signed();
+        SetPose(state.current, arg & 3, Pos{from.x + dx, from.y + dy});
+        break;
+      }
+      case eOp::Lock:
+        state.Lock(in.Byte(), in.Type(arg));
+        break;
+      case eOp::Score:
+        state.score += static_cast<int>(UnZigZag(in.Varint()));
+        break;
+      case eOp::Level:
+        state.level = static_cast<int>(in.Varint());
+        break;
+      default:
+        throw std::runtime_error("unknown spectator message");
+    }
+  }
+}
+
+}  // namespace tetris
@@ -0,0 +1,174 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Tetris/Tetris.h"
+
+namespace tetris {
+
+//! what a spectator sees of a game
+struct SpectatorState {
+  int width{};
+  int height{};
+  std::vector<uint64_t> rows;              //!< bit x of rows[y] is set when (x,y) is occupied
+  std::vector<Tetriminos::eColor> colors;  //!< [y * width + x], meaningful on occupied cells
+  Tetriminos current;
+  std::vector<Tetriminos::eType> next;
+  int score{};
+  int lines{};
+  int level{};
+
+  //!@param preview number of next tetriminos to follow
+  template <class Traits>
+  static SpectatorState Of(const BasicTetris<Traits>& game, int preview);
+
+  bool operator==(const SpectatorState& other) const;
+  bool operator!=(const SpectatorState& other) const { return !(*this == other); }
+
+  int DropDistance() const;
+  //! the engine locking the current tetriminos @param drop rows below: blocks are stamped,
+  //! full rows cleared, @param incoming enters the preview and the next tetriminos spawns
+  void Lock(int drop, Tetriminos::eType incoming);
+};
+
+//! spectator stream: compact binary deltas of a game, decoded by DeltaDecoder
+//!
+//! call Encode() after each input and timer event given to the engine. Moves cost 3 bytes,
+//! a lock 2 bytes, as line clears and spawns are replayed by the decoder. A keyframe of
+//! the whole state is sent periodically, and whenever the actions since the last call
+//! cannot be replayed (i.e. garbage, several locks, moves before a lock)
+class DeltaEncoder {
+ public:
+  //!@param preview number of next tetriminos sent, at most the engine buffer depth
+  //!@param keyframe_interval number of Encode() calls between two keyframes
+  explicit DeltaEncoder(int preview = 1, int keyframe_interval = 600);
+
+  //! append to @param out the changes of @param game since the last call
+  template <class Traits>
+  void Encode(const BasicTetris<Traits>& game, std::vector<uint8_t>& out);
+
+  //! next Encode() sends a keyframe, for a spectator joining the stream
+  void RequestKeyframe() { since_keyframe = keyframe_interval; }
+  int Keyframes() const { return keyframes; }
+
+ private:
+  template <class Traits>
+  void Keyframe(const BasicTetris<Traits>& game, std::vector<uint8_t>& out);
+  template <class Traits>
+  bool Matches(const BasicTetris<Traits>& game) const;
+  void EncodeLock(int drop, Tetriminos::eType incoming, std::vector<uint8_t>& out);
+  void EncodeChanges(const Tetriminos& current, int score, int level, std::vector<uint8_t>& out);
+
+  int preview;
+  int keyframe_interval;
+  int since_keyframe;
+  int keyframes{};
+  size_t history{};  //!< actions already encoded
+  SpectatorState shadow;  //!< state of the decoders
+};
+
+class DeltaDecoder {
+ public:
+  //! apply the messages of @param data, throws on malformed data
+  void Decode(const uint8_t* data, size_t size);
+  void Decode(const std::vector<uint8_t>& data) { Decode(data.data(), data.size()); }
+
+  //! false until the first keyframe
+  bool IsSynchronized() const { return synchronized; }
+  const SpectatorState& State() const { return state; }
+
+ private:
+  SpectatorState state;
+  bool synchronized{false};
+};
+
+namespace detail {
+void EncodeKeyframe(const SpectatorState& state, std::vector<uint8_t>& out);
+}  // namespace detail
+
+template <class Traits>
+SpectatorState SpectatorState::Of(const BasicTetris<Traits>& game, int preview) {
+  SpectatorState state;
+  state.width = game.Width();
+  state.height = game.Height();
+  state.colors.resize(static_cast<size_t>(state.width) * state.height);
+  for (int y = 0; y < state.height; y++)
+    state.rows.push_back(game.Playfield().RowMask(y));
+  game.Playfield().ForEachBlock([&state](const Pos& pos, Tetriminos::eColor color) {
+    state.colors[pos.y * state.width + pos.x] = color;
+  });
+  state.current = game.Current();
+  for (int offset = 0; offset < preview; offset++)
+    state.next.push_back(game.Next(offset).Type());
+  state.score = game.Scoring().Score();
+  state.lines = game.Scoring().CompletedLines();
+  state.level = game.Scoring().Level();
+  return state;
+}
+
+template <class Traits>
+void DeltaEncoder::Encode(const BasicTetris<Traits>& game, std::vector<uint8_t>& out) {
+  const auto& actions = game.History();
+  int lands = 0;
+  bool replayable = history <= actions.size();
+  bool hard_drop = false;
+  bool moved = false;
+  for (size_t i = replayable ? history : actions.size(); i < actions.size(); i++) {
+    switch (actions[i]) {
+      case eAction::Land:
+        replayable &= !moved;  // the pose the tetriminos landed from was not sent
+        lands++;
+        break;
+      case eAction::HardDrop:
+        hard_drop = true;
+        break;
+      case eAction::Left:
+      case eAction::Right:
+      case eAction::Rotate:
+      case eAction::Down:
+        moved = true;
+        break;
+      case eAction::Garbage:
+        replayable = false;
+        break;
+      default:
+        break;
+    }
+  }
+  history = actions.size();
+
+  if (++since_keyframe > keyframe_interval || !replayable || lands > 1) {
+    Keyframe(game, out);
+    return;
+  }
+  if (lands) {
+    const auto lock_begin = out.size();
+    const auto incoming = preview ? game.Next(preview - 1).Type() : game.Current().Type();
+    EncodeLock(hard_drop ? shadow.DropDistance() : 0, incoming, out);
+    if (!Matches(game)) {
+      out.resize(lock_begin);
+      Keyframe(game, out);
+      return;
+    }
+  }
+  EncodeChanges(game.Current(), game.Scoring().Score(), game.Scoring().Level(), out);
+}
+
+template <class Traits>
+void DeltaEncoder::Keyframe(const BasicTetris<Traits>& game, std::vector<uint8_t>& out) {
+  shadow = SpectatorState::Of(game, preview);
+  detail::EncodeKeyframe(shadow, out);
+  since_keyframe = 0;
+  keyframes++;
+}
+
+template <class Traits>
+bool DeltaEncoder::Matches(const BasicTetris<Traits>& game) const {
+  for (int y = 0; y < shadow.height; y++) {
+    if (shadow.rows[y] != game.Playfield().RowMask(y))
+      return false;
+  }
+  return shadow.current.Type() == game.Current().Type() &&
+         shadow.lines == game.Scoring().CompletedLines();
+}
+
+}  // namespace tetris
@@ -19,26 +19,8 @@ Tetriminos::eType FromString(std::string type_p) {
 Tetriminos::Tetriminos(std::string type_p) : Tetriminos(FromString(type_p)) {}
 
 Tetriminos::Tetriminos(eType type_p) : type(type_p) {
-  blocks = [this]() {
-    switch (type) {
-      case eType::I:
-        return std::vector<Pos>{{0, 0}, {1, 0}, {2, 0}, {3, 0}};
-      case eType::O:
-        return std::vector<Pos>{{0, 0}, {1, 0}, {0, 1}, {1, 1}};
-      case eType::T:
-        return std::vector<Pos>{{-1, 0}, {0, 0}, {1, 0}, {0, -1}};
-      case eType::L:
-        return std::vector<Pos>{{0, 0}, {0, 1}, {0, 2}, {1, 2}};
-      case eType::J:
-        return std::vector<Pos>{{0, 0}, {0, 1}, {0, 2}, {-1, 2}};
-      case eType::Z:
-        return std::vector<Pos>{{-1, 0}, {0, 0}, {0, 1}, {1, 1}};
-      case eType::S:
-        return std::vector<Pos>{{-1, 1}, {0, 1}, {0, 0}, {1, 0}};
-      default:
-        throw std::runtime_error("cannot create blocks of this unkinw type");
-    };
-  }();
+  if (type >= eType::Count)
+    throw std::runtime_error("cannot create blocks of this unkinw type");
 }
 
 bool Collision(const std::vector<Pos>& a, const std::vector<Pos>& b) {
@@ -47,24 +29,6 @@ bool Collision(const std::vector<Pos>& a, const std::vector<Pos>& b) {
   });
 }
 
-void Tetriminos::Rotate() {
-  // x2=cosβx1−sinβy1
-  // y2=sinβx1+cosβy1
-  std::for_each(blocks.begin(), blocks.end(), [](Pos& pos) {
-    auto x = pos.x;
-    pos.x = -pos.y;
-    pos.y = x;
-  });
-}
-
-std::vector<Pos> Tetriminos::BlocksAbsolutePosition() const {
-  std::vector<Pos> ret(blocks.size());
-  std::transform(blocks.begin(), blocks.end(), ret.begin(), [this](const Pos& pos) {
-    return Pos{this->position.x + pos.x, this->position.y + pos.y};
-  });
-  return ret;
-}
-
 void Tetriminos::MoveDown() {
   position.y++;
 }
@@ -76,7 +40,7 @@ void Tetriminos::MoveRight() {
 }
 
 Tetriminos::eColor Tetriminos::ToColor(eType type_p) {
-  static_assert(static_cast<int>(eType::Count) == static_cast<int>(eColor::Count));
+  static_assert(static_cast<int>(eType::Count) == static_cast<int>(eColor::Gray));
   if (type_p >= eType::Count)
     throw std::runtime_error("Tetriminos::ToColor , invalid input parameter");
   return static_cast<eColor>(static_cast<int>(type_p));
@@ -92,7 +56,7 @@ std::ostream& operator<<(std::ostream& out, const Tetriminos::eType& type) {
 
 std::ostream& operator<<(std::ostream& out, const Tetriminos::eColor& color) {
   static std::array<std::string, static_cast<size_t>(Tetriminos::eColor::Count)> types{
-      "Cyan", "Yellow", "Purple", "Orange", "Blue", "Red", "Green",
+      "Cyan", "Yellow", "Purple", "Orange", "Blue", "Red", "Green", "Gray",
   };
   return out << types.at(static_cast<size_t>(color));
 }
@@ -1,28 +1,50 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <list>
 #include <ostream>
 #include <random>
+#include <stdexcept>
+#include <vector>
 namespace tetris {
 
 struct Pos {
   int x{};
   int y{};
 
-  bool operator==(const Pos& other_p) const { return x == other_p.x && y == other_p.y; }
+  constexpr bool operator==(const Pos& other_p) const {
+    return x == other_p.x && y == other_p.y;
+  }
 };
 
 std::ostream& operator<<(std::ostream& out, const Pos& pos);
 
 bool Collision(const std::vector<Pos>& a, const std::vector<Pos>& b);
 
+//! bounding box of blocks, limits are included
+struct Bounds {
+  int left{};
+  int right{};
+  int top{};
+  int bottom{};
+};
+
 struct Tetriminos {
   enum class eType { I, O, T, L, J, Z, S, Count };
   static constexpr size_t BlockTypeCount() { return static_cast<size_t>(eType::Count); }
   using Collection = std::array<Tetriminos::eType, static_cast<size_t>(eType::Count)>;
 
-  enum class eColor { Cyan, Yellow, Purple, Orange, Blue, Red, Green, Count };
+  //! Gray is for garbage rows, not a tetriminos color
+  enum class eColor { Cyan, Yellow, Purple, Orange, Blue, Red, Green, Gray, Count };
+
+  //! blocks position relative to Position()
+  using Shape = std::array<Pos, 4>;
+  //! offsets tried in order when rotating, first one is always (0,0)
+  using Kicks = std::array<Pos, 5>;
+
+  //! super rotation system states: 0 is spawn state, then each clockwise quarter turn
+  static constexpr int kRotationCount = 4;
 
   explicit Tetriminos(eType type_p);
   explicit Tetriminos(std::string type_p);
@@ -36,11 +58,20 @@ struct Tetriminos {
   static eColor ToColor(eType type_p);
 
   Pos Position() const { return position; }
+  int Rotation() const { return rotation; }
 
-  const std::vector<Pos>& BlocksPosition() const { return blocks; }
-  std::vector<Pos> BlocksAbsolutePosition() const;
+  const Shape& BlocksPosition() const;
+  Shape BlocksAbsolutePosition() const;
+  //! relative to Position(), depends on rotation
+  const Bounds& BlocksBounds() const;
 
-  void Rotate();
+  //! offsets to try after a Rotate() (clockwise) or RotateBack() from @param from state
+  static const Kicks& RotationKicks(eType type, int from, bool clockwise);
+
+  //! clockwise
+  void Rotate() { rotation = (rotation + 1) % kRotationCount; }
+  //! counter clockwise
+  void RotateBack() { rotation = (rotation + kRotationCount - 1) % kRotationCount; }
   void MoveDown();
   void MoveLeft();
   void MoveRight();
@@ -48,10 +79,126 @@ struct Tetriminos {
   void SetY(int y) { position.y = y; }
 
  private:
-  eType type;
+  eType type{eType::I};
   Pos position;
-  std::vector<Pos> blocks;
+  int rotation{};
 };
+
+//! Super Rotation System tables
+//! @ref https://tetris.wiki/Super_Rotation_System
+//! y axis goes down, spawn shapes have their lowest row at y = 0 (I, T, L, J) or 1 (O, Z, S)
+namespace srs {
+
+constexpr size_t kTypeCount = static_cast<size_t>(Tetriminos::eType::Count);
+using ShapeTable =
+    std::array<std::array<Tetriminos::Shape, Tetriminos::kRotationCount>, kTypeCount>;
+using BoundsTable = std::array<std::array<Bounds, Tetriminos::kRotationCount>, kTypeCount>;
+//! [from state][0: clockwise, 1: counter clockwise]
+using KickTable = std::array<std::array<Tetriminos::Kicks, 2>, Tetriminos::kRotationCount>;
+
+//! JLSTZ states are quarter turns of the spawn shape around @param center
+constexpr std::array<Tetriminos::Shape, 4> Turns(Tetriminos::Shape spawn, Pos center) {
+  std::array<Tetriminos::Shape, 4> states{};
+  states[0] = spawn;
+  for (int r = 1; r < 4; r++) {
+    for (int i = 0; i < 4; i++) {
+      const Pos p = states[r - 1][i];
+      states[r][i] = Pos{center.x - (p.y - center.y), center.y + (p.x - center.x)};
+    }
+  }
+  return states;
+}
+
+constexpr ShapeTable kShapes{{
+    // I, rotates around the center of its 4x4 box
+    {{{{{0, 0}, {1, 0}, {2, 0}, {3, 0}}},
+      {{{2, -1}, {2, 0}, {2, 1}, {2, 2}}},
+      {{{0, 1}, {1, 1}, {2, 1}, {3, 1}}},
+      {{{1, -1}, {1, 0}, {1, 1}, {1, 2}}}}},
+    // O, does not rotate
+    {{{{{0, 0}, {1, 0}, {0, 1}, {1, 1}}},
+      {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}},
+      {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}},
+      {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}}}},
+    Turns({{{-1, 0}, {0, 0}, {1, 0}, {0, -1}}}, {0, 0}),  // T
+    Turns({{{-1, 0}, {0, 0}, {1, 0}, {1, -1}}}, {0, 0}),  // L
+    Turns({{{-1, -1}, {-1, 0}, {0, 0}, {1, 0}}}, {0, 0}), // J
+    Turns({{{-1, 0}, {0, 0}, {0, 1}, {1, 1}}}, {0, 1}),   // Z
+    Turns({{{-1, 1}, {0, 1}, {0, 0}, {1, 0}}}, {0, 1}),   // S
+}};
+
+constexpr Bounds BoundsOf(const Tetriminos::Shape& shape) {
+  Bounds b{shape[0].x, shape[0].x, shape[0].y, shape[0].y};
+  for (const Pos& p : shape) {
+    b.left = p.x < b.left ? p.x : b.left;
+    b.right = p.x > b.right ? p.x : b.right;
+    b.top = p.y < b.top ? p.y : b.top;
+    b.bottom = p.y > b.bottom ? p.y : b.bottom;
+  }
+  return b;
+}
+
+constexpr BoundsTable MakeBounds() {
+  BoundsTable table{};
+  for (size_t t = 0; t < kTypeCount; t++)
+    for (int r = 0; r < Tetriminos::kRotationCount; r++)
+      table[t][r] = BoundsOf(kShapes[t][r]);
+  return table;
+}
+
+constexpr BoundsTable kBounds = MakeBounds();
+
+// wiki tables use y up, y is negated here
+constexpr KickTable kJLSTZKicks{{
+    {{{{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}},   // 0->R
+      {{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}}}},    // 0->L
+    {{{{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},     // R->2
+      {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}}}},   // R->0
+    {{{{{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}}},      // 2->L
+      {{{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}}}}}, // 2->R
+    {{{{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}},  // L->0
+      {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}}}}, // L->2
+}};
+
+constexpr KickTable kIKicks{{
+    {{{{{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}}},   // 0->R
+      {{{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}}}}},  // 0->L
+    {{{{{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}}},   // R->2
+      {{{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}}}}},  // R->0
+    {{{{{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}}},   // 2->L
+      {{{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}}}}},  // 2->R
+    {{{{{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}}},   // L->0
+      {{{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}}}}},  // L->2
+}};
+
+constexpr KickTable kNoKicks{};
+
+}  // namespace srs
+
+inline const Tetriminos::Shape& Tetriminos::BlocksPosition() const {
+  return srs::kShapes[static_cast<size_t>(type)][rotation];
+}
+
+inline const Bounds& Tetriminos::BlocksBounds() const {
+  return srs::kBounds[static_cast<size_t>(type)][rotation];
+}
+
+inline Tetriminos::Shape Tetriminos::BlocksAbsolutePosition() const {
+  Shape ret = BlocksPosition();
+  for (Pos& pos : ret) {
+    pos.x += position.x;
+    pos.y += position.y;
+  }
+  return ret;
+}
+
+inline const Tetriminos::Kicks& Tetriminos::RotationKicks(eType type, int from, bool clockwise) {
+  const auto& table = type == eType::I   ? srs::kIKicks
+                      : type == eType::O ? srs::kNoKicks
+                                         : srs::kJLSTZKicks;
+  return table[from][clockwise ? 0 : 1];
+}
+
 std::ostream& operator<<(std::ostream& out, const Tetriminos::eType& type);
 std::ostream& operator<<(std::ostream& out, const Tetriminos::eColor& color);
 
@@ -60,23 +207,24 @@ struct ITetriminosGenerator {
   virtual Tetriminos Create() = 0;
 };
 
-class TetriminosFactory {
-  ITetriminosGenerator& generator;
-  std::list<Tetriminos> buffer;
+//! preview buffer, a ring refilled in place so taking a tetriminos does not allocate
+//! @tparam Generator ITetriminosGenerator, or a final implementation to inline Create()
+template <class Generator = ITetriminosGenerator>
+class BasicTetriminosFactory {
+  Generator& generator;
+  std::vector<Tetriminos> buffer;
+  size_t head{};
 
  public:
-  explicit TetriminosFactory(ITetriminosGenerator& generator_p, int buffer_depth)
-      : generator(generator_p), buffer(buffer_depth) {
-    std::generate(buffer.begin(), buffer.end(),
-                  std::bind(&ITetriminosGenerator::Create, std::ref(generator)));
+  explicit BasicTetriminosFactory(Generator& generator_p, int buffer_depth)
+      : generator(generator_p), buffer(ThrowIfEmpty(buffer_depth)) {
+    std::generate(buffer.begin(), buffer.end(), [this] { return generator.Create(); });
   }
 
   Tetriminos Take() {
-    auto t = buffer.front();
-    buffer.pop_front();
-
-    buffer.push_back(generator.Create());
-
+    auto t = buffer[head];
+    buffer[head] = generator.Create();
+    head = head + 1 == buffer.size() ? 0 : head + 1;
     return t;
   }
 
@@ -85,11 +233,36 @@ class TetriminosFactory {
       throw std::runtime_error("try to access not allowed tetriminos");
     }
 
-    return *std::next(buffer.begin(), offset);
+    return buffer[(head + offset) % buffer.size()];
+  }
+
+  //! preview content, the generator is saved by its owner
+  struct State {
+    std::vector<Tetriminos> buffer;
+    size_t head{};
+  };
+  void SaveState(State& state) const {
+    state.buffer = buffer;
+    state.head = head;
+  }
+  void LoadState(const State& state) {
+    if (state.buffer.size() != buffer.size())
+      throw std::runtime_error("tetriminos buffer depth does not match the saved state");
+    buffer = state.buffer;
+    head = state.head;
+  }
+
+ private:
+  static size_t ThrowIfEmpty(int buffer_depth) {
+    if (buffer_depth < 1)
+      throw std::runtime_error("tetriminos buffer depth must be positive");
+    return static_cast<size_t>(buffer_depth);
   }
 };
 
-struct TetriminosGenerator : ITetriminosGenerator {
+using TetriminosFactory = BasicTetriminosFactory<>;
+
+struct TetriminosGenerator final : ITetriminosGenerator {
   explicit TetriminosGenerator(int seed) { gen.seed(seed); };
   Tetriminos Create() override;
 
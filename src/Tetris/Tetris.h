@@ -1,8 +1,11 @@
 #pragma once
 #include <chrono>
+#include "Tetris/Board.h"
+#include "Tetris/EngineStats.h"
 #include "Tetris/IScore.h"
 #include "Tetris/ITimer.h"
 #include "Tetris/IUserInput.h"
+#include "Tetris/LockDelay.h"
 #include "Tetris/Tetriminos.h"
 namespace tetris {
 
@@ -24,54 +27,112 @@ enum class eAction {
   Right,
   Rotate,
   Down,
+  HardDrop,
 
   CollisionWall,
   CollisionStale,
   CollisionFloor,
 
+  LockDelay,
   Land,
+  Garbage,
   GameOver,
 };
 
 using ActionHistory = std::vector<eAction>;
 
-class Tetris : public InputListener, public TimerListener {
-  ITimer& timer;
-  IScore& score;
-  TetriminosFactory generator;
+//! engine configuration, customize it by inheriting and hiding some members
+//! @example struct MyTraits : DefaultTraits { using Stats = EngineStats; };
+struct DefaultTraits {
+  //! receive counters and timings, see EngineStats.h
+  using Stats = NoEngineStats;
+  //! playfield, size is given to the engine constructor
+  using Board = tetris::Board;
+  //! collaborators, final implementations let the compiler inline the calls of the engine
+  using Score = IScore;
+  using Timer = ITimer;
+  using Generator = ITetriminosGenerator;
+};
+
+struct ProfiledTraits : DefaultTraits {
+  using Stats = EngineStats;
+};
+
+//! compile time playfield size, loops on rows and columns are constant folded
+template <int W, int H>
+struct FixedSizeTraits : DefaultTraits {
+  using Board = BasicBoard<W, H>;
+};
+
+//! the engine, see TetrisImpl.h to instanciate it with other traits
+template <class Traits = DefaultTraits>
+class BasicTetris : public InputListener, public TimerListener {
+ public:
+  using Stats = typename Traits::Stats;
+  using Board = typename Traits::Board;
+  using Score = typename Traits::Score;
+  using Timer = typename Traits::Timer;
+  using Generator = typename Traits::Generator;
+
+ private:
+  Timer& timer;
+  Score& score;
+  BasicTetriminosFactory<Generator> generator;
   Tetriminos current;
-  Blocks stale_blocks;
+  Board board;
   ActionHistory actions;
-  int width{10};
-  int height{25};
-  std::vector<Pos> left_wall;
-  std::vector<Pos> right_wall;
-  std::vector<Pos> floor;
-  //
+  LockCountdown lock;
+  // frame driven mode
+  int64_t frame{};
+  int64_t lock_deadline{};  //!< frame the lock delay expires
+  Gravity gravity;          //!< of the current level
+  int32_t fall{};           //!< accumulated gravity, in Gravity::kCell
+  bool topped_out{false};   //!< by garbage
+  // stale blocks, ghost, walls and floor are only generated for renderers
+  mutable Blocks stale_blocks;
+  mutable bool stale_blocks_outdated{false};
+  mutable Tetriminos ghost;
+  mutable bool ghost_outdated{true};
+  mutable std::vector<Pos> left_wall;
+  mutable std::vector<Pos> right_wall;
+  mutable std::vector<Pos> floor;
+  mutable Stats stats;
 
  public:
   // int seed =
-  explicit Tetris(UserInput& user_input,
-                  ITimer& timer,
-                  IScore& score_p,
-                  ITetriminosGenerator& gen,
-                  int buffer_depth);
+  explicit BasicTetris(UserInput& user_input,
+                       Timer& timer,
+                       Score& score_p,
+                       Generator& gen,
+                       int buffer_depth,
+                       BoardSize board_size = Board::DefaultSize());
 
-  int Width() const { return width; }
-  int Height() const { return height; }
-  Pos StartPosition() const { return Pos{width / 2, 0}; }
+  int Width() const { return board.Width(); }
+  int Height() const { return board.Height(); }
+  Pos StartPosition() const { return Pos{Width() / 2, 0}; }
 
   void Down();
   void OnTimerEvent(const ITimer& timer) override;
 
+  //! frame driven mode: run @param nb_frames frames of gravity and lock delay at 60Hz,
+  //! stops on pause or game over. The timer only tells the pause state then,
+  //! use one that does not fire by itself (i.e. a VirtualTimer never advanced)
+  //!@return number of frames run
+  int AdvanceFrames(int nb_frames);
+  //! frames run since construction
+  int64_t Frame() const { return frame; }
+
   // blocks
 
   Tetriminos Current() const { return current; }
+  //! Current() at its landing position, cached until the tetriminos or the playfield change
+  const Tetriminos& Ghost() const;
   Tetriminos Next(int offset = 0) const { return generator.Next(offset); }
-  const Blocks& StaleBlocks() const { return stale_blocks; }
-  const std::vector<Pos>& LeftWall() const { return left_wall; }
-  const std::vector<Pos>& RightWall() const { return right_wall; }
-  const std::vector<Pos>& Floor() const { return floor; }
+  const Blocks& StaleBlocks() const;
+  const Board& Playfield() const { return board; }
+  const std::vector<Pos>& LeftWall() const;
+  const std::vector<Pos>& RightWall() const;
+  const std::vector<Pos>& Floor() const;
 
   const ActionHistory& History() const { return actions; }
   eAction LastAction() const {
@@ -82,37 +143,114 @@ class Tetris : public InputListener, public TimerListener {
 
   bool IsOver() const;
 
+  //! replace the lock delay policy, the current tetriminos starts over
+  void SetLockDelay(const LockDelay& policy);
+  const LockDelay& LockPolicy() const { return lock.Policy(); }
+  //! current tetriminos is on the ground, waiting for its lock delay
+  bool IsLocking() const { return lock.IsRunning(); }
+
+  //! push @param nb_rows garbage rows, full but @param hole_column, under the playfield.
+  //! the current tetriminos rises with the stack when they overlap. The game is over
+  //! when stale blocks are pushed over the ceiling or the current tetriminos above it
+  void AddGarbage(int nb_rows, int hole_column);
+
+  //! Zobrist hash of the stale blocks and the current tetriminos, for searches
+  uint64_t Hash() const { return board.Hash() ^ zobrist::PieceKey(current); }
+
+  //! number of rows the current tetriminos can fall before landing
+  int DropDistance() const { return board.DropDistance(current); }
+
   std::vector<int> FindCompletedLines() const;
   Blocks MorphToBlocks(const Tetriminos& t) const;
 
-  const IScore& Scoring() const { return score; }
+  const Score& Scoring() const { return score; }
   bool IsPause() const { return !timer.IsStarted(); }
 
+  const Stats& Statistics() const { return stats; }
+
+  //! engine state for rollback and replays, the collaborators (score, generator, timer)
+  //! are saved by their owner. Saving over a previous State reuses its memory
+  struct State {
+    Tetriminos current;
+    Board board;
+    typename BasicTetriminosFactory<Generator>::State preview;
+    LockCountdown lock;
+    int64_t frame{};
+    int64_t lock_deadline{};
+    Gravity gravity;
+    int32_t fall{};
+    bool topped_out{false};
+    size_t nb_actions{};
+  };
+  void SaveState(State& state) const;
+  //! @pre @param state saved by this engine, the actions done since are dropped from History()
+  void LoadState(const State& state);
+
  protected:
   ///  events
   void OnLeft() override;
   void OnRight() override;
   void OnRotate() override;
+  void OnReverseRotate() override;
   void OnFastDown() override;
+  void OnHardDrop() override;
   void OnPause() override { timer.Stop(); }
   void OnResume() override;
 
  protected:
   void LoadNext();
+  void Rotate(bool clockwise);
+  //!@return NoAction if @param t fits, else the first collision found
+  eAction Collide(const Tetriminos& t) const;
   bool CollideWithLeftWall(const Tetriminos& t) const;
   bool CollideWithRightWall(const Tetriminos& t) const;
   bool CollideWithStaleBlocks(const Tetriminos& t) const;
   bool CollideWithFloor(const Tetriminos& t) const;
   void Land();
+  void LockAndClearLines();
 
   void RemoveAllBlocksInLine(int line);
   void ApplyGravity(std::vector<int> line);
   void ApplyGravity(int line);
-  void AddStaleBlock(const Block& block) { stale_blocks.push_back(block); }
+  void AddStaleBlock(const Block& block);
 
   void SetCurrent(const Tetriminos& t);
+  void MoveCurrent(const Tetriminos& t) {
+    current = t;
+    ghost_outdated = true;
+  }
+  //! lowest row of the current tetriminos blocks
+  int BottomRow() const { return current.Position().y + current.BlocksBounds().bottom; }
+  //! current tetriminos moved or rotated by the player
+  void OnMoved() {
+    if (lock.OnMove())
+      StartLockDelay();
+  }
+  void StartLockDelay() {
+    lock_deadline = frame + FramesOf(lock.Policy().Delay());
+    Restart(lock.Policy().Delay());
+  }
+  //! change the timer period unless the game is paused
+  void Restart(std::chrono::milliseconds period) {
+    if (timer.IsStarted())
+      timer.Start(period);
+  }
+  void OnPlayfieldChanged() {
+    stale_blocks_outdated = true;
+    ghost_outdated = true;
+  }
 
   void ThrowIfOffGridBlock(const Pos& pos) const;
 };
 
+using Tetris = BasicTetris<DefaultTraits>;
+using ProfiledTetris = BasicTetris<ProfiledTraits>;
+template <int W, int H>
+using FixedSizeTetris = BasicTetris<FixedSizeTraits<W, H>>;
+
+extern template class BasicTetris<DefaultTraits>;
+extern template class BasicTetris<ProfiledTraits>;
+extern template class BasicTetris<FixedSizeTraits<10, 20>>;
+extern template class BasicTetris<FixedSizeTraits<10, 40>>;
+
 }  // namespace tetris
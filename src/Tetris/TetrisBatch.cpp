@@ -0,0 +1,325 @@
+#include "TetrisBatch.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace tetris {
+
+namespace {
+
+//! row i of a tetriminos is y = bounds.top + i, bit 0 is x = bounds.left
+using PieceMask = std::array<TetrisBatch::Row, 4>;
+using MaskTable = std::array<std::array<PieceMask, Tetriminos::kRotationCount>, srs::kTypeCount>;
+
+constexpr MaskTable MakeMasks() {
+  MaskTable table{};
+  for (size_t t = 0; t < srs::kTypeCount; t++) {
+    for (int r = 0; r < Tetriminos::kRotationCount; r++) {
+      const Bounds& b = srs::kBounds[t][r];
+      for (const Pos& p : srs::kShapes[t][r]) {
+        auto& row = table[t][r][p.y - b.top];
+        row = static_cast<TetrisBatch::Row>(row | (1u << (p.x - b.left)));
+      }
+    }
+  }
+  return table;
+}
+
+constexpr MaskTable kMasks = MakeMasks();
+
+//! the rows of a PieceMask in one word, row i in bits [16 * i, 16 * i + 16)
+constexpr std::array<std::array<uint64_t, Tetriminos::kRotationCount>, srs::kTypeCount>
+MakePacked() {
+  std::array<std::array<uint64_t, Tetriminos::kRotationCount>, srs::kTypeCount> table{};
+  for (size_t t = 0; t < srs::kTypeCount; t++) {
+    for (int r = 0; r < Tetriminos::kRotationCount; r++) {
+      for (int i = 0; i < 4; i++)
+        table[t][r] |= uint64_t{kMasks[t][r][i]} << (16 * i);
+    }
+  }
+  return table;
+}
+
+constexpr auto kPacked = MakePacked();
+static_assert(TetrisBatch::kMaxWidth <= 16, "a piece row is 16 bits of a packed mask");
+
+constexpr std::array<int, 5> kLineGain{0, 40, 100, 300, 1200};
+
+//! xorshift state of @param game, never 0
+uint32_t SeedOf(uint32_t seed, int game) {
+  uint32_t z = seed + 0x9E3779B9u * static_cast<uint32_t>(game + 1);
+  z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+  z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+  z ^= z >> 16;
+  return z ? z : 1;
+}
+
+}  // namespace
+
+TetrisBatch::TetrisBatch(int nb_games_p, uint32_t seed, BoardSize size, int preview_p)
+    : nb_games(nb_games_p), width(size.width), height(size.height), preview(preview_p) {
+  if (nb_games < 1)
+    throw std::runtime_error("a batch needs at least one game");
+  if (width < 4 || width > kMaxWidth)
+    throw std::runtime_error("batch board width must be in [4,16]");
+  if (height < 4 || height > 64)
+    throw std::runtime_error("batch board height must be in [4,64]");
+  if (preview < 1)
+    throw std::runtime_error("batch preview must be positive");
+
+  full_row = static_cast<Row>((1u << width) - 1);
+
+  const auto n = static_cast<size_t>(nb_games);
+  rows.resize(n * height);
+  type.resize(n);
+  rotation.resize(n);
+  x.resize(n);
+  y.resize(n);
+  queue.resize(n * preview);
+  rng.resize(n);
+  score.resize(n);
+  lines.resize(n);
+  reward.resize(n);
+  over.resize(n);
+  locked.resize(n);
+  full_rows.resize(n);
+  packed.resize(n);
+  base.resize(n);
+  blocked.resize(n);
+
+  for (int game = 0; game < nb_games; game++)
+    Reset(game, seed);
+}
+
+void TetrisBatch::Reset(int game, uint32_t seed) {
+  for (int row = 0; row < height; row++)
+    rows[Cell(game, row)] = 0;
+  rng[game] = SeedOf(seed, game);
+  score[game] = 0;
+  lines[game] = 0;
+  reward[game] = 0;
+  over[game] = 0;
+  for (int offset = 0; offset < preview; offset++)
+    queue[static_cast<size_t>(offset) * nb_games + game] = RandomType(game);
+  Spawn(game);
+  score[game] = reward[game];
+  reward[game] = 0;
+}
+
+void TetrisBatch::Step(const std::vector<eBatchAction>& actions) {
+  if (actions.size() != static_cast<size_t>(nb_games))
+    throw std::runtime_error("batch step needs one action per game");
+  Step(actions.data());
+}
+
+void TetrisBatch::Step(const eBatchAction* actions) {
+  // player actions, branchy, one game at a time
+  for (int g = 0; g < nb_games; g++) {
+    reward[g] = 0;
+    locked[g] = 0;
+    if (over[g])
+      continue;
+
+    switch (actions[g]) {
+      case eBatchAction::Left:
+        Move(g, -1);
+        break;
+      case eBatchAction::Right:
+        Move(g, 1);
+        break;
+      case eBatchAction::Rotate:
+        Rotate(g, true);
+        break;
+      case eBatchAction::ReverseRotate:
+        Rotate(g, false);
+        break;
+      case eBatchAction::SoftDrop:
+        if (Fits(g, type[g], rotation[g], x[g], y[g] + 1)) {
+          y[g]++;
+          reward[g] += 1;
+        } else {
+          locked[g] = 1;
+        }
+        break;
+      case eBatchAction::HardDrop: {
+        const int distance = DropDistance(g);
+        y[g] = static_cast<int8_t>(y[g] + distance);
+        reward[g] += 2 * distance;
+        locked[g] = 1;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  ApplyGravity();
+
+  for (int g = 0; g < nb_games; g++) {
+    if (locked[g])
+      Stamp(g);
+  }
+
+  // full rows, row y of every game is contiguous
+  std::fill(full_rows.begin(), full_rows.end(), 0);
+  for (int row = 0; row < height; row++) {
+    const Row* games = &rows[Cell(0, row)];
+    for (int g = 0; g < nb_games; g++)
+      full_rows[g] |= uint64_t{games[g] == full_row} << row;
+  }
+
+  for (int g = 0; g < nb_games; g++) {
+    if (!locked[g])
+      continue;
+    if (full_rows[g])
+      ClearLines(g, full_rows[g]);
+    Spawn(g);
+  }
+
+  for (int g = 0; g < nb_games; g++)
+    score[g] += reward[g];
+}
+
+void TetrisBatch::ApplyGravity() {
+  // piece rows one cell lower, shifted at their column. Pieces already fit the walls,
+  // only the floor and the stale blocks can stop them
+  int first = height;
+  int last = -1;
+  for (int g = 0; g < nb_games; g++) {
+    const Bounds& b = srs::kBounds[type[g]][rotation[g]];
+    const bool active = !over[g] && !locked[g];
+    packed[g] = active ? kPacked[type[g]][rotation[g]] << (x[g] + b.left) : 0;
+    base[g] = y[g] + b.top + 1;
+    blocked[g] = active && y[g] + b.bottom + 1 >= height;
+    first = std::min(first, base[g]);
+    last = std::max(last, base[g] + 3);
+  }
+
+  // branch free pass over the rows the pieces can reach, row y of every game is contiguous
+  first = std::max(first, 0);
+  last = std::min(last, height - 1);
+  for (int row = first; row <= last; row++) {
+    const Row* games = &rows[Cell(0, row)];
+    for (int g = 0; g < nb_games; g++) {
+      const auto i = static_cast<unsigned>(row - base[g]);
+      const uint64_t piece = i < 4 ? packed[g] >> (16 * (i & 3)) : 0;
+      blocked[g] |= (piece & games[g]) != 0;
+    }
+  }
+
+  for (int g = 0; g < nb_games; g++) {
+    const int active = !over[g] && !locked[g];
+    y[g] = static_cast<int8_t>(y[g] + (active & !blocked[g]));
+    locked[g] = static_cast<uint8_t>(locked[g] | (active & blocked[g]));
+  }
+}
+
+Tetriminos TetrisBatch::Current(int game) const {
+  Tetriminos t{static_cast<Tetriminos::eType>(type[game])};
+  for (int r = 0; r < rotation[game]; r++)
+    t.Rotate();
+  t.SetX(x[game]);
+  t.SetY(y[game]);
+  return t;
+}
+
+Tetriminos::eType TetrisBatch::Next(int game, int offset) const {
+  if (offset < 0 || offset >= preview)
+    throw std::runtime_error("try to access not allowed tetriminos");
+  return static_cast<Tetriminos::eType>(queue[static_cast<size_t>(offset) * nb_games + game]);
+}
+
+int TetrisBatch::DropDistance(int game) const {
+  int distance = 0;
+  while (Fits(game, type[game], rotation[game], x[game], y[game] + distance + 1))
+    distance++;
+  return distance;
+}
+
+bool TetrisBatch::Fits(int game, int t, int r, int px, int py) const {
+  const Bounds& b = srs::kBounds[t][r];
+  if (px + b.left < 0 || px + b.right >= width || py + b.bottom >= height)
+    return false;
+
+  const PieceMask& mask = kMasks[t][r];
+  for (int i = 0; i <= b.bottom - b.top; i++) {
+    const int row = py + b.top + i;
+    if (row >= 0 && (static_cast<unsigned>(mask[i]) << (px + b.left)) & rows[Cell(game, row)])
+      return false;  // rows above the ceiling are free
+  }
+  return true;
+}
+
+void TetrisBatch::Move(int game, int dx) {
+  if (Fits(game, type[game], rotation[game], x[game] + dx, y[game]))
+    x[game] = static_cast<int8_t>(x[game] + dx);
+}
+
+void TetrisBatch::Rotate(int game, bool clockwise) {
+  const int from = rotation[game];
+  const int turn = clockwise ? 1 : Tetriminos::kRotationCount - 1;
+  const int to = (from + turn) % Tetriminos::kRotationCount;
+  const auto t = static_cast<Tetriminos::eType>(type[game]);
+  for (const Pos& kick : Tetriminos::RotationKicks(t, from, clockwise)) {
+    if (Fits(game, type[game], to, x[game] + kick.x, y[game] + kick.y)) {
+      rotation[game] = static_cast<uint8_t>(to);
+      x[game] = static_cast<int8_t>(x[game] + kick.x);
+      y[game] = static_cast<int8_t>(y[game] + kick.y);
+      return;
+    }
+  }
+}
+
+void TetrisBatch::Stamp(int game) {
+  const Bounds& b = srs::kBounds[type[game]][rotation[game]];
+  const PieceMask& mask = kMasks[type[game]][rotation[game]];
+  for (int i = 0; i <= b.bottom - b.top; i++) {
+    const int row = y[game] + b.top + i;
+    if (row < 0)
+      continue;  // above ceil, game is over anyway
+    auto& cells = rows[Cell(game, row)];
+    cells = static_cast<Row>(cells | (static_cast<unsigned>(mask[i]) << (x[game] + b.left)));
+  }
+}
+
+void TetrisBatch::ClearLines(int game, uint64_t full) {
+  int nb_line = 0;
+  int dst = height - 1;
+  for (int src = height - 1; src >= 0; src--) {
+    if ((full >> src) & 1) {
+      nb_line++;
+      continue;
+    }
+    rows[Cell(game, dst--)] = rows[Cell(game, src)];
+  }
+  for (; dst >= 0; dst--)
+    rows[Cell(game, dst)] = 0;
+
+  const int level = 1 + lines[game] / 10;
+  reward[game] += kLineGain[nb_line] * level;
+  lines[game] += nb_line;
+}
+
+void TetrisBatch::Spawn(int game) {
+  type[game] = queue[game];
+  for (int offset = 1; offset < preview; offset++)
+    queue[static_cast<size_t>(offset - 1) * nb_games + game] =
+        queue[static_cast<size_t>(offset) * nb_games + game];
+  queue[static_cast<size_t>(preview - 1) * nb_games + game] = RandomType(game);
+
+  rotation[game] = 0;
+  x[game] = static_cast<int8_t>(width / 2);
+  y[game] = 0;
+  reward[game] += 1;  // nintendo scoring counts each new tetriminos
+  over[game] = !Fits(game, type[game], 0, x[game], 0);
+}
+
+uint8_t TetrisBatch::RandomType(int game) {
+  uint32_t s = rng[game];
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  rng[game] = s;
+  return static_cast<uint8_t>(s % srs::kTypeCount);
+}
+
+}  // namespace tetris
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Tetris/Board.h"
+#include "Tetris/Tetriminos.h"
+
+namespace tetris {
+
+enum class eBatchAction : uint8_t {
+  None,
+  Left,
+  Right,
+  Rotate,
+  ReverseRotate,
+  SoftDrop,
+  HardDrop,
+  Count
+};
+
+//! many games stepped in lockstep, for training workloads
+//!
+//! every field is an array indexed by game (struct of arrays) and board rows are stored
+//! row major: row y of all games is contiguous. The gravity collision test and the full
+//! row scan are branch free passes over these rows, across games instead of across cells.
+//! player actions (moves, kicked rotations, drops) stay branchy, one game at a time.
+//! rules follow Tetris: super rotation system, classic lock, nintendo scoring,
+//! a game over freezes the game until Reset()
+class TetrisBatch {
+ public:
+  using Row = uint16_t;
+  static constexpr int kMaxWidth = 16;
+
+  //!@param seed of the per game random generators, game g is seeded with a mix of seed and g
+  //!@param preview number of next tetriminos
+  TetrisBatch(int nb_games, uint32_t seed, BoardSize size = BoardSize{}, int preview = 1);
+
+  int Size() const { return nb_games; }
+  int Width() const { return width; }
+  int Height() const { return height; }
+  int Preview() const { return preview; }
+
+  //! apply actions[g] to game g, then a gravity step to every running game
+  //!@param actions one per game
+  void Step(const eBatchAction* actions);
+  void Step(const std::vector<eBatchAction>& actions);
+
+  //! empty board, score and queue, fresh random generator
+  void Reset(int game, uint32_t seed);
+
+  bool IsOver(int game) const { return over[game]; }
+  int Score(int game) const { return score[game]; }
+  int Lines(int game) const { return lines[game]; }
+  //! score gained during the last Step()
+  int Reward(int game) const { return reward[game]; }
+
+  //! bit x is set when cell (x,y) is occupied
+  Row RowMask(int game, int y) const { return rows[Cell(game, y)]; }
+  Tetriminos Current(int game) const;
+  Tetriminos::eType Next(int game, int offset = 0) const;
+  //! number of rows the current tetriminos of @param game can fall
+  int DropDistance(int game) const;
+
+ private:
+  size_t Cell(int game, int y) const { return static_cast<size_t>(y) * nb_games + game; }
+  bool Fits(int game, int type, int rotation, int x, int y) const;
+  //! fall or lock every running game not locked by its action
+  void ApplyGravity();
+  void Move(int game, int dx);
+  void Rotate(int game, bool clockwise);
+  void Stamp(int game);
+  void ClearLines(int game, uint64_t full_rows);
+  void Spawn(int game);
+  uint8_t RandomType(int game);
+
+  int nb_games;
+  int width;
+  int height;
+  int preview;
+  Row full_row;
+
+  std::vector<Row> rows;         //!< [y * nb_games + game]
+  std::vector<uint8_t> type;     //!< current tetriminos
+  std::vector<uint8_t> rotation;
+  std::vector<int8_t> x;
+  std::vector<int8_t> y;
+  std::vector<uint8_t> queue;    //!< [offset * nb_games + game]
+  std::vector<uint32_t> rng;     //!< xorshift state
+  std::vector<int32_t> score;
+  std::vector<int32_t> lines;
+  std::vector<int32_t> reward;
+  std::vector<uint8_t> over;
+  // per step scratch
+  std::vector<uint8_t> locked;
+  std::vector<uint64_t> full_rows;
+  std::vector<uint64_t> packed;  //!< piece rows at their column, see ApplyGravity()
+  std::vector<int> base;         //!< playfield row of the first piece row
+  std::vector<uint8_t> blocked;
+};
+
+}  // namespace tetris
@@ -0,0 +1,483 @@
+#pragma once
+//! BasicTetris definitions, include it only to instanciate the engine with custom traits
+#include <algorithm>
+#include "Tetris/Tetris.h"
+namespace tetris {
+
+template <class Traits>
+BasicTetris<Traits>::BasicTetris(UserInput& user_input,
+                                 Timer& timer,
+                                 Score& score_p,
+                                 Generator& gen,
+                                 int buffer_depth,
+                                 BoardSize board_size)
+    : timer(timer),
+      score(score_p),
+      generator(gen, buffer_depth),
+      board(board_size),
+      gravity(score.GravityPerFrame()) {
+  user_input.SetListener(*this);
+  timer.Register(this);
+  LoadNext();
+}
+
+template <class Traits>
+const std::vector<Pos>& BasicTetris<Traits>::LeftWall() const {
+  if (left_wall.empty()) {
+    for (int y = 0; y < Height(); y++)
+      left_wall.push_back(Pos{-1, y});
+  }
+  return left_wall;
+}
+
+template <class Traits>
+const std::vector<Pos>& BasicTetris<Traits>::RightWall() const {
+  if (right_wall.empty()) {
+    for (int y = 0; y < Height(); y++)
+      right_wall.push_back(Pos{Width(), y});
+  }
+  return right_wall;
+}
+
+template <class Traits>
+const std::vector<Pos>& BasicTetris<Traits>::Floor() const {
+  if (floor.empty()) {
+    for (int x = -1; x <= Width(); x++)
+      floor.push_back(Pos{x, Height()});
+  }
+  return floor;
+}
+
+template <class Traits>
+const Blocks& BasicTetris<Traits>::StaleBlocks() const {
+  if (stale_blocks_outdated) {
+    stale_blocks.clear();
+    board.ForEachBlock([this](const Pos& pos, Tetriminos::eColor color) {
+      stale_blocks.push_back(Block{pos, color});
+    });
+    stale_blocks_outdated = false;
+  }
+  return stale_blocks;
+}
+
+template <class Traits>
+const Tetriminos& BasicTetris<Traits>::Ghost() const {
+  if (ghost_outdated) {
+    ghost = current;
+    ghost.SetY(current.Position().y + DropDistance());
+    ghost_outdated = false;
+  }
+  return ghost;
+}
+
+template <class Traits>
+void BasicTetris<Traits>::AddStaleBlock(const Block& block) {
+  ThrowIfOffGridBlock(block.pos);
+  if (block.pos.y < 0)
+    return;  // above ceil, game is over anyway
+
+  board.Set(block.pos, block.color);
+  OnPlayfieldChanged();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::AddGarbage(int nb_rows, int hole_column) {
+  if (hole_column < 0 || hole_column >= Width())
+    throw std::runtime_error("garbage hole is out of the playfield");
+  if (nb_rows <= 0)
+    return;
+
+  using Row = typename Board::Row;
+  actions.push_back(eAction::Garbage);
+  const auto row = static_cast<Row>(board.FullRow() & ~(Row{1} << hole_column));
+  topped_out |= board.PushRowsUp(nb_rows, row, Tetriminos::eColor::Gray);
+  OnPlayfieldChanged();
+
+  auto lifted = current;
+  for (int i = 0; i < nb_rows && CollideWithStaleBlocks(lifted); i++)
+    lifted.SetY(lifted.Position().y - 1);
+  if (lifted.Position().y != current.Position().y)
+    MoveCurrent(lifted);
+  topped_out |= current.Position().y + current.BlocksBounds().bottom < 0;
+}
+
+template <class Traits>
+void BasicTetris<Traits>::SaveState(State& state) const {
+  state.current = current;
+  state.board = board;
+  generator.SaveState(state.preview);
+  state.lock = lock;
+  state.frame = frame;
+  state.lock_deadline = lock_deadline;
+  state.gravity = gravity;
+  state.fall = fall;
+  state.topped_out = topped_out;
+  state.nb_actions = actions.size();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::LoadState(const State& state) {
+  current = state.current;
+  board = state.board;
+  generator.LoadState(state.preview);
+  lock = state.lock;
+  frame = state.frame;
+  lock_deadline = state.lock_deadline;
+  gravity = state.gravity;
+  fall = state.fall;
+  topped_out = state.topped_out;
+  if (state.nb_actions < actions.size())
+    actions.resize(state.nb_actions);
+  OnPlayfieldChanged();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::LoadNext() {
+  stats.Count(eEngineCounter::PieceSpawned);
+  score.OnNewTetriminos();
+  SetCurrent(generator.Take());
+}
+
+template <class Traits>
+void BasicTetris<Traits>::SetCurrent(const Tetriminos& t) {
+  if (lock.IsRunning())
+    Restart(score.DropPeriod());  // back to gravity
+
+  MoveCurrent(t);
+  current.SetX(Width() / 2);  // initial position
+  lock.OnSpawn(BottomRow());
+}
+
+template <class Traits>
+void BasicTetris<Traits>::SetLockDelay(const LockDelay& policy) {
+  if (lock.IsRunning())
+    Restart(score.DropPeriod());
+  lock = LockCountdown{policy};
+  lock.OnSpawn(BottomRow());
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnResume() {
+  if (!timer.IsStarted())
+    timer.Start(lock.IsRunning() ? lock.Policy().Delay() : score.DropPeriod());
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnRotate() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  Rotate(true);
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnReverseRotate() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  Rotate(false);
+}
+
+template <class Traits>
+void BasicTetris<Traits>::Rotate(bool clockwise) {
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::Rotate);
+  actions.push_back(eAction::TryRotate);
+
+  auto rotated = current;
+  clockwise ? rotated.Rotate() : rotated.RotateBack();
+
+  // super rotation system: try each kick, report the collision of the unkicked rotation
+  eAction first_collision = eAction::NoAction;
+  for (const Pos& kick : Tetriminos::RotationKicks(current.Type(), current.Rotation(), clockwise)) {
+    auto c = rotated;
+    c.SetX(rotated.Position().x + kick.x);
+    c.SetY(rotated.Position().y + kick.y);
+
+    const eAction collision = Collide(c);
+    if (collision == eAction::NoAction) {
+      MoveCurrent(c);
+      actions.push_back(eAction::Rotate);
+      OnMoved();
+      return;
+    }
+    if (first_collision == eAction::NoAction)
+      first_collision = collision;
+  }
+
+  stats.Count(eEngineCounter::RotationRejected);
+  actions.push_back(first_collision);
+}
+
+template <class Traits>
+eAction BasicTetris<Traits>::Collide(const Tetriminos& t) const {
+  if (CollideWithStaleBlocks(t))
+    return eAction::CollisionStale;
+  if (CollideWithLeftWall(t) || CollideWithRightWall(t))
+    return eAction::CollisionWall;
+  if (CollideWithFloor(t))
+    return eAction::CollisionFloor;
+  return eAction::NoAction;
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnLeft() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::Left);
+  auto c = current;
+  actions.push_back(eAction::TryLeft);
+  c.MoveLeft();
+
+  if (CollideWithStaleBlocks(c)) {
+    actions.push_back(eAction::CollisionStale);
+    return;
+  }
+
+  if (CollideWithLeftWall(c)) {
+    actions.push_back(eAction::CollisionWall);
+    return;
+  }
+  MoveCurrent(c);
+  actions.push_back(eAction::Left);
+  OnMoved();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnRight() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::Right);
+  auto c = current;
+  actions.push_back(eAction::TryRight);
+  c.MoveRight();
+
+  if (CollideWithStaleBlocks(c)) {
+    actions.push_back(eAction::CollisionStale);
+    return;
+  }
+
+  if (CollideWithRightWall(c)) {
+    actions.push_back(eAction::CollisionWall);
+    return;
+  }
+  MoveCurrent(c);
+  actions.push_back(eAction::Right);
+  OnMoved();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnFastDown() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::FastDown);
+  score.OnSoftDrop();
+  actions.push_back(eAction::TryDown);
+  Down();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnHardDrop() {
+  TETRIS_LATENCY_SCOPE(Engine);
+  if (IsPause())
+    return;
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::HardDrop);
+  const int distance = DropDistance();
+  current.SetY(current.Position().y + distance);
+  score.OnHardDrop(distance);
+  actions.push_back(eAction::HardDrop);
+  LockAndClearLines();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::OnTimerEvent(const ITimer& timer) {
+  if (IsOver()) {
+    actions.push_back(eAction::GameOver);
+    return;
+  }
+
+  Down();
+}
+
+template <class Traits>
+int BasicTetris<Traits>::AdvanceFrames(int nb_frames) {
+  int done = 0;
+  for (; done < nb_frames && !IsPause() && !IsOver(); done++) {
+    frame++;
+    if (lock.IsRunning() && DropDistance() == 0) {
+      if (frame >= lock_deadline)
+        Down();  // locks
+      continue;
+    }
+
+    fall += gravity.per_frame;
+    while (fall >= Gravity::kCell) {  // several cells per frame above 1G
+      fall -= Gravity::kCell;
+      Down();
+      if (LastAction() != eAction::Down) {
+        fall = 0;  // landed or locking, next tetriminos starts from scratch
+        break;
+      }
+    }
+  }
+  return done;
+}
+
+template <class Traits>
+void BasicTetris<Traits>::Down() {
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::Down);
+  auto next_pos = current;
+  next_pos.MoveDown();
+
+  if (CollideWithStaleBlocks(next_pos) || CollideWithFloor(next_pos)) {
+    if (lock.OnBlocked()) {
+      LockAndClearLines();
+      return;
+    }
+    actions.push_back(eAction::LockDelay);
+    StartLockDelay();
+    return;
+  }
+
+  actions.push_back(eAction::Down);
+  current = next_pos;  // landing position is the same, ghost is still valid
+  if (lock.OnFall(BottomRow()))
+    Restart(score.DropPeriod());  // slid off a ledge
+}
+
+template <class Traits>
+void BasicTetris<Traits>::LockAndClearLines() {
+  Land();
+  if (auto completed_lines = FindCompletedLines(); completed_lines.size()) {
+    stats.LinesCleared(completed_lines.size());
+    if (score.OnCompletedLine(completed_lines.size())) {
+      timer.Start(score.DropPeriod());  // level changed
+      gravity = score.GravityPerFrame();
+    }
+    for (auto line : completed_lines) {
+      RemoveAllBlocksInLine(line);
+    }
+    if (board.IsEmpty()) {
+      score.OnPerfectClear();  //  wouah
+    } else {
+      ApplyGravity(completed_lines);
+    }
+  }
+}
+
+template <class Traits>
+void BasicTetris<Traits>::Land() {
+  [[maybe_unused]] auto timing = stats.Time(eEngineOperation::Land);
+  actions.push_back(eAction::Land);
+
+  auto blocks = MorphToBlocks(current);
+  for (auto& block : blocks)
+    AddStaleBlock(block);
+
+  LoadNext();
+}
+
+template <class Traits>
+bool BasicTetris<Traits>::CollideWithLeftWall(const Tetriminos& t) const {
+  stats.Count(eEngineCounter::CollisionLeftWall);
+  return t.Position().x + t.BlocksBounds().left < 0;
+}
+
+template <class Traits>
+bool BasicTetris<Traits>::CollideWithRightWall(const Tetriminos& t) const {
+  stats.Count(eEngineCounter::CollisionRightWall);
+  return t.Position().x + t.BlocksBounds().right >= Width();
+}
+
+template <class Traits>
+bool BasicTetris<Traits>::CollideWithFloor(const Tetriminos& t) const {
+  stats.Count(eEngineCounter::CollisionFloor);
+  return t.Position().y + t.BlocksBounds().bottom >= Height();
+}
+
+template <class Traits>
+bool BasicTetris<Traits>::CollideWithStaleBlocks(const Tetriminos& t) const {
+  stats.Count(eEngineCounter::CollisionStaleBlocks);
+  const Pos origin = t.Position();
+  const auto& blocks = t.BlocksPosition();
+  return std::any_of(blocks.begin(), blocks.end(), [&](const Pos& pos) {
+    return board.IsOccupied(Pos{origin.x + pos.x, origin.y + pos.y});
+  });
+}
+
+template <class Traits>
+bool BasicTetris<Traits>::IsOver() const {
+  return topped_out || (current.Position() == StartPosition() && CollideWithStaleBlocks(current));
+}
+
+template <class Traits>
+void BasicTetris<Traits>::ThrowIfOffGridBlock(const Pos& pos) const {
+  if (pos.x < 0) {
+    throw std::runtime_error(" block over left wall");
+  }
+  if (pos.x >= Width()) {
+    throw std::runtime_error(" block over right wall");
+  }
+
+  if (pos.y >= Height()) {
+    throw std::runtime_error(" block is over floor");
+  }
+
+  // dont check ceil because can overide at start posistion
+}
+
+template <class Traits>
+Blocks BasicTetris<Traits>::MorphToBlocks(const Tetriminos& t) const {
+  auto abs_pos_t = t.BlocksAbsolutePosition();
+
+  Blocks blocks(abs_pos_t.size());
+  auto color = t.ColorHint();
+
+  std::transform(abs_pos_t.begin(), abs_pos_t.end(), blocks.begin(),
+                 [this, color](const Pos& abs_pos) {
+                   ThrowIfOffGridBlock(abs_pos);
+
+                   return Block{abs_pos, color};
+                 });
+
+  return blocks;
+}
+
+template <class Traits>
+std::vector<int> BasicTetris<Traits>::FindCompletedLines() const {
+  std::vector<int> ret;
+  for (int y = 0; y < Height(); y++) {
+    if (board.IsFull(y)) {
+      ret.push_back(y);
+    }
+  }
+
+  return ret;
+}
+
+template <class Traits>
+void BasicTetris<Traits>::RemoveAllBlocksInLine(int line) {
+  board.ClearRow(line);
+  OnPlayfieldChanged();
+}
+
+template <class Traits>
+void BasicTetris<Traits>::ApplyGravity(std::vector<int> lines) {
+  // require  lines are sorted
+  std::sort(lines.begin(), lines.end(), std::less<int>());
+
+  for (auto line : lines) {
+    ApplyGravity(line);
+  }
+}
+
+template <class Traits>
+void BasicTetris<Traits>::ApplyGravity(int line) {
+  stats.Count(eEngineCounter::GravityPass);
+  board.DropRowsAbove(line);
+  OnPlayfieldChanged();
+}
+
+}  // namespace tetris
@@ -0,0 +1,221 @@
+#pragma once
+#include <Tetris/Board.h>
+#include <Tetris/ITimer.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+namespace tetris {
+
+class TimerWheel;
+
+//! ITimer scheduled by a TimerWheel shared with many other timers
+//! must not outlive its wheel
+class WheelTimer final : public ITimer {
+ public:
+  explicit WheelTimer(TimerWheel& wheel_p) : wheel(wheel_p) { link.owner = this; }
+  inline ~WheelTimer();
+  WheelTimer(const WheelTimer&) = delete;
+  WheelTimer& operator=(const WheelTimer&) = delete;
+
+  inline void Start(const std::chrono::milliseconds& period_p) override;
+  inline void Stop() override;
+
+  std::chrono::milliseconds Period() const { return std::chrono::milliseconds{period}; }
+
+ private:
+  friend class TimerWheel;
+
+  //! node of the intrusive list of a wheel slot
+  struct Link {
+    Link* prev{this};
+    Link* next{this};
+    WheelTimer* owner{};  //!< null for slot heads
+  };
+
+  void Fire() { Step(); }
+
+  Link link;
+  TimerWheel& wheel;
+  int64_t period{};
+  int64_t deadline{};  //!< in wheel ticks
+  int level{-1};       //!< slot the timer is linked in, -1 when unlinked
+  int slot{};
+};
+
+//! hierarchical timer wheel: kLevels wheels of kSlots slots, level L slots span
+//! kSlots^L milliseconds. A timer is linked in the slot of its deadline at the coarsest
+//! level where it differs from now, and moves down a level each time the wheel reaches
+//! its slot, so start, stop and period changes are O(1) and a tick only visits the
+//! timers that expire. Deadlines further than the top level wait there.
+//! time is given by the owner, in milliseconds since construction
+class TimerWheel {
+ public:
+  static constexpr int kSlotBits = 6;
+  static constexpr int kSlots = 1 << kSlotBits;
+  static constexpr int kLevels = 4;
+  //! milliseconds covered by the levels, about 4.6 hours
+  static constexpr int64_t kRange = int64_t{1} << (kSlotBits * kLevels);
+
+  TimerWheel() = default;
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  std::chrono::milliseconds Now() const { return std::chrono::milliseconds{now}; }
+  //! started timers
+  int Size() const { return size; }
+
+  //! move the wheel forward to @param target, firing every timer due meanwhile in
+  //! deadline order. Listeners may start or stop any timer from their event
+  //!@return number of events fired
+  int AdvanceTo(std::chrono::milliseconds target) {
+    int fired = 0;
+    while (now < target.count()) {
+      if (size == 0) {
+        now = target.count();
+        break;
+      }
+      // jump over empty slots, stopping at block starts where upper levels move down
+      const int64_t next = std::min(NextTick(), target.count());
+      now = next - 1;
+      fired += Tick();
+    }
+    return fired;
+  }
+
+  //! time to wait before AdvanceTo() may fire a timer, exact when a timer expires
+  //! within the current kSlots milliseconds, a lower bound otherwise
+  std::chrono::milliseconds TimeToNextEvent() const {
+    if (size == 0)
+      return std::chrono::milliseconds::max();
+    return std::chrono::milliseconds{NextTick() - now};
+  }
+
+ private:
+  friend class WheelTimer;
+  using Link = WheelTimer::Link;
+
+  static constexpr int64_t kSlotMask = kSlots - 1;
+
+  //! first time after now with a level 0 slot to fire or a block start
+  int64_t NextTick() const {
+    const int current = static_cast<int>(now & kSlotMask);
+    const uint64_t later = current == kSlotMask ? 0 : occupied[0] & ~LowBits(current + 1);
+    if (later)
+      return (now & ~kSlotMask) + CountTrailingZeros(later);
+    return (now | kSlotMask) + 1;
+  }
+
+  void Schedule(WheelTimer& timer) {
+    const int64_t distance = timer.deadline ^ now;
+    int level = 0;
+    int64_t slot_time = timer.deadline;
+    if (timer.deadline - now >= kRange) {
+      level = kLevels - 1;  // too far, waits for the last block before now comes back
+      slot_time = now - (int64_t{1} << (kSlotBits * level));
+    } else {
+      while (level + 1 < kLevels && (distance >> (kSlotBits * (level + 1))) != 0)
+        level++;
+    }
+    const int slot = static_cast<int>((slot_time >> (kSlotBits * level)) & kSlotMask);
+
+    Link& head = slots[level][slot];
+    timer.link.prev = head.prev;
+    timer.link.next = &head;
+    head.prev->next = &timer.link;
+    head.prev = &timer.link;
+    timer.level = level;
+    timer.slot = slot;
+    occupied[level] |= uint64_t{1} << slot;
+  }
+
+  void Unlink(WheelTimer& timer) {
+    Link& link = timer.link;
+    link.prev->next = link.next;
+    link.next->prev = link.prev;
+    link.prev = link.next = &link;
+    if (timer.level >= 0) {
+      const Link& head = slots[timer.level][timer.slot];
+      if (head.next == &head)
+        occupied[timer.level] &= ~(uint64_t{1} << timer.slot);
+      timer.level = -1;
+    }
+  }
+
+  //! moves the timers of a slot to @param pending, their slot is forgotten
+  void Detach(int level, int slot, Link& pending) {
+    Link& head = slots[level][slot];
+    occupied[level] &= ~(uint64_t{1} << slot);
+    if (head.next == &head)
+      return;
+    pending.next = head.next;
+    pending.prev = head.prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    head.next = head.prev = &head;
+    for (Link* link = pending.next; link != &pending; link = link->next)
+      link->owner->level = -1;
+  }
+
+  int Tick() {
+    now++;
+
+    // at the start of a block, timers of the matching upper slot move down
+    for (int level = 1; level < kLevels; level++) {
+      if (now & ((int64_t{1} << (kSlotBits * level)) - 1))
+        break;
+      const int slot = static_cast<int>((now >> (kSlotBits * level)) & kSlotMask);
+      if (!(occupied[level] >> slot & 1))
+        continue;
+      Link pending;
+      Detach(level, slot, pending);
+      while (pending.next != &pending) {
+        WheelTimer& timer = *pending.next->owner;
+        Unlink(timer);
+        Schedule(timer);
+      }
+    }
+
+    // level 0 slots only hold timers expiring now
+    Link pending;
+    Detach(0, static_cast<int>(now & kSlotMask), pending);
+    int fired = 0;
+    while (pending.next != &pending) {
+      WheelTimer& timer = *pending.next->owner;
+      Unlink(timer);
+      timer.deadline += timer.period;  // before Fire, the listener may Start again
+      Schedule(timer);
+      timer.Fire();
+      fired++;
+    }
+    return fired;
+  }
+
+  std::array<std::array<Link, kSlots>, kLevels> slots{};
+  std::array<uint64_t, kLevels> occupied{};  //!< bit s is set when slot s may hold timers
+  int64_t now{};
+  int size{};
+};
+
+WheelTimer::~WheelTimer() {
+  Stop();
+}
+
+void WheelTimer::Start(const std::chrono::milliseconds& period_p) {
+  if (period_p.count() <= 0)
+    throw std::runtime_error("wheel timer period must be positive");
+  wheel.Unlink(*this);
+  period = period_p.count();
+  deadline = wheel.now + period;
+  wheel.Schedule(*this);
+  wheel.size += !started;
+  started = true;
+}
+
+void WheelTimer::Stop() {
+  wheel.Unlink(*this);
+  wheel.size -= started;
+  started = false;
+}
+
+}  // namespace tetris
@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace tetris {
+
+//! fixed size hash table of search results shared by search threads, without locks.
+//! entries are stored as (key ^ data, data) pairs: a torn write by two threads fails the
+//! key check on probe and reads as a miss, see https://www.chessprogramming.org/Shared_Hash_Table
+//!
+//! a bucket is a cache line of kBucketSize entries. Store() replaces the entry of the same
+//! key, else the entry of the oldest search, then the shallowest one
+class TranspositionTable {
+ public:
+  enum class eBound : uint8_t { None, Exact, Lower, Upper };
+
+  struct Entry {
+    int32_t value{};
+    uint16_t move{};  //!< best move, in the caller's encoding
+    uint8_t depth{};
+    eBound bound{eBound::None};
+  };
+
+  static constexpr int kBucketSize = 4;
+
+  //!@param nb_entries rounded down to a power of two buckets
+  explicit TranspositionTable(size_t nb_entries) {
+    if (nb_entries < kBucketSize)
+      throw std::runtime_error("transposition table must hold a bucket");
+    size_t nb_buckets = 1;
+    while (nb_buckets * 2 * kBucketSize <= nb_entries)
+      nb_buckets *= 2;
+    buckets = std::make_unique<Bucket[]>(nb_buckets);
+    mask = nb_buckets - 1;
+  }
+
+  size_t Capacity() const { return (mask + 1) * kBucketSize; }
+
+  //! entries of previous searches become the first to be replaced
+  //! not thread safe, call it between searches
+  void NewSearch() { generation = (generation + 1) & kGenerationMask; }
+
+  //! not thread safe
+  void Clear() {
+    for (size_t i = 0; i <= mask; i++) {
+      for (auto& slot : buckets[i].slots) {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  //!@return true and @param entry when @param key is found
+  bool Probe(uint64_t key, Entry& entry) const {
+    for (const auto& slot : BucketOf(key).slots) {
+      const uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if ((slot.check.load(std::memory_order_relaxed) ^ data) == key && data) {
+        entry = Unpack(data);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Store(uint64_t key, const Entry& entry) {
+    Bucket& bucket = BucketOf(key);
+    Slot* victim = &bucket.slots[0];
+    int victim_score = std::numeric_limits<int>::max();
+    for (auto& slot : bucket.slots) {
+      const uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if ((slot.check.load(std::memory_order_relaxed) ^ data) == key || !data) {
+        victim = &slot;
+        break;
+      }
+      // older searches first, then shallower: depths are below 256
+      const int age = (generation - GenerationOf(data)) & kGenerationMask;
+      const int score = Unpack(data).depth - 256 * age;
+      if (score < victim_score) {
+        victim_score = score;
+        victim = &slot;
+      }
+    }
+    const uint64_t data = Pack(entry);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+  }
+
+  //! permille of entries written by the current search, sampled on the first 1000 entries
+  int Usage() const {
+    int used = 0;
+    int sampled = 0;
+    for (size_t i = 0; i < 1000 / kBucketSize && i <= mask; i++) {
+      for (const auto& slot : buckets[i].slots) {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        used += data && GenerationOf(data) == generation;
+        sampled++;
+      }
+    }
+    return used * 1000 / sampled;
+  }
+
+ private:
+  static constexpr int kGenerationMask = 0x1f;
+
+  struct Slot {
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};  //!< 0 is an empty slot
+  };
+  struct alignas(64) Bucket {
+    Slot slots[kBucketSize];
+  };
+
+  //! value:32 move:16 depth:8 bound:2 generation:5, the used bit makes data non null
+  uint64_t Pack(const Entry& entry) const {
+    return uint64_t{static_cast<uint32_t>(entry.value)} | uint64_t{entry.move} << 32 |
+           uint64_t{entry.depth} << 48 | uint64_t{static_cast<uint8_t>(entry.bound)} << 56 |
+           uint64_t{static_cast<uint32_t>(generation)} << 58 | uint64_t{1} << 63;
+  }
+  static Entry Unpack(uint64_t data) {
+    return Entry{static_cast<int32_t>(static_cast<uint32_t>(data)),
+                 static_cast<uint16_t>(data >> 32), static_cast<uint8_t>(data >> 48),
+                 static_cast<eBound>((data >> 56) & 3)};
+  }
+  static int GenerationOf(uint64_t data) { return static_cast<int>(data >> 58) & kGenerationMask; }
+
+  Bucket& BucketOf(uint64_t key) const { return buckets[key & mask]; }
+
+  std::unique_ptr<Bucket[]> buckets;
+  size_t mask{};
+  int generation{};
+};
+
+}  // namespace tetris
@@ -0,0 +1,62 @@
+#pragma once
+#include <Tetris/ITimer.h>
+#include <chrono>
+#include <stdexcept>
+namespace tetris {
+
+//! timer on simulated time: nothing happens until the owner advances it,
+//! so headless games and tests run as fast as the cpu allows
+struct VirtualTimer final : public ITimer {
+  using Duration = std::chrono::nanoseconds;
+
+  void Start(const std::chrono::milliseconds& period_p) override {
+    if (period_p.count() <= 0)
+      throw std::runtime_error("virtual timer period must be positive");
+    period = period_p;
+    next_event = now + period;
+    started = true;
+  }
+  void Stop() override { started = false; }
+
+  //! move simulated time forward by @param delay, firing every event due meanwhile
+  //! listeners may restart or stop the timer from their event
+  //!@return number of events fired
+  int Advance(Duration delay) {
+    const Duration target = now + delay;
+    int fired = 0;
+    while (started && next_event <= target) {
+      Fire();
+      fired++;
+    }
+    now = target;
+    return fired;
+  }
+
+  //! jump to the next event and fire it
+  //!@return false if the timer is stopped
+  bool AdvanceToNextEvent() {
+    if (!started)
+      return false;
+    Fire();
+    return true;
+  }
+
+  //! simulated time since construction, stopped periods included
+  Duration Now() const { return now; }
+  Duration Period() const { return period; }
+  //!@pre IsStarted()
+  Duration TimeToNextEvent() const { return next_event - now; }
+
+ private:
+  void Fire() {
+    now = next_event;
+    next_event += period;  // before Step, the listener may Start again
+    Step();
+  }
+
+  Duration now{};
+  Duration period{};
+  Duration next_event{};
+};
+
+}  // namespace tetris
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "Tetris/Tetriminos.h"
+
+namespace tetris {
+
+//! Zobrist keys: a position hashes to the xor of the keys of its features, so adding or
+//! removing a feature updates the hash with a single xor
+namespace zobrist {
+
+constexpr int kMaxSize = 64;
+//! tetriminos origins may be out of the playfield, any 128 consecutive values have their key
+constexpr int kPosRange = 128;
+constexpr int kTypes = static_cast<int>(Tetriminos::eType::Count);
+
+struct Keys {
+  std::array<uint64_t, kMaxSize> columns{};   //!< key of the cell (x,0), see CellKey()
+  std::array<uint64_t, kTypes * 4> pieces{};  //!< [type * 4 + rotation]
+  std::array<uint64_t, kPosRange> x{};
+  std::array<uint64_t, kPosRange> y{};
+};
+
+//! splitmix64, keys are the same on every build
+constexpr uint64_t NextKey(uint64_t& state) {
+  uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+constexpr Keys MakeKeys() {
+  Keys keys;
+  uint64_t state = 0x7e7715;
+  for (auto& key : keys.columns)
+    key = NextKey(state);
+  for (auto& key : keys.pieces)
+    key = NextKey(state);
+  for (auto& key : keys.x)
+    key = NextKey(state);
+  for (auto& key : keys.y)
+    key = NextKey(state);
+  return keys;
+}
+
+inline constexpr Keys kKeys = MakeKeys();
+
+//!@pre 0 <= n < 64
+constexpr uint64_t RotateLeft(uint64_t v, int n) {
+  return n == 0 ? v : (v << n) | (v >> (64 - n));
+}
+
+//! the key of (x,y) is the key of its column rotated by y, so moving every cell n rows
+//! up rotates the hash right by n instead of rehashing the cells
+//!@pre (x,y) in a kMaxSize x kMaxSize playfield
+inline uint64_t CellKey(int x, int y) {
+  return RotateLeft(kKeys.columns[x], y);
+}
+
+//! type, rotation and position of @param t
+inline uint64_t PieceKey(const Tetriminos& t) {
+  const Pos pos = t.Position();
+  return kKeys.pieces[static_cast<int>(t.Type()) * 4 + t.Rotation()] ^
+         kKeys.x[pos.x & (kPosRange - 1)] ^ kKeys.y[pos.y & (kPosRange - 1)];
+}
+
+}  // namespace zobrist
+
+}  // namespace tetris
@@ -1,7 +1,10 @@
+#include <Tetris/FrameComposer.h>
 #include <Tetris/KeyboardInput.h>
+#include <Tetris/LatencyProbe.h>
 #include <Tetris/NintendoClassicScore.h>
 #include <Tetris/PollingTimer.h>
 #include <Tetris/Tetris.h>
+#include <csignal>
 #include <iostream>
 #include "rlutil.h"
 
@@ -9,9 +12,17 @@ using namespace tetris;
 
 int cpt{};
 
-void Draw(const Tetris& game);
+#if defined(TETRIS_WITH_LATENCY_PROBES)
+volatile std::sig_atomic_t dump_latency{};
+void OnDumpLatencySignal(int) {
+  dump_latency = 1;
+}
+#endif
 
 int main() {
+#if defined(TETRIS_WITH_LATENCY_PROBES) && defined(SIGUSR1)
+  std::signal(SIGUSR1, OnDumpLatencySignal);  // kill -USR1 <pid> to dump on stderr
+#endif
   PollingTimer timer;
 
   auto user_input =
@@ -19,87 +30,55 @@ int main() {
           .AssignLeft<int>(rlutil::KEY_LEFT)  // force cast because rlutil use unamed enum...
           .AssignRight<int>(rlutil::KEY_RIGHT)
           .AssignRotate<int>(rlutil::KEY_UP)
+          .AssignReverseRotate<int>('z')
           .AssignMoveDown<int>(rlutil::KEY_DOWN)
-          .AssignPause<int>(rlutil::KEY_SPACE)
+          .AssignHardDrop<int>(rlutil::KEY_SPACE)
+          .AssignPause<int>('p')
           .AssignResume<int>(rlutil::KEY_ENTER)
           .Build();
 
   NintendoClassicScore score;
   TetriminosGenerator gen(std::random_device{}());
   Tetris game(user_input, timer, score, gen, 1);
+  game.SetLockDelay(LockDelay::MoveReset(std::chrono::milliseconds{500}));
 
-  Draw(game);
+  FrameComposer composer(game.Playfield().Size(), true);
+  rlutil::cls();
+  rlutil::hidecursor();
+  std::cout.flush();  // frames are written to the fd, after the buffered clear screen
+  const auto draw = [&composer](const Tetris& game) { composer.Draw(game); };
+  draw(game);
 
   while (!game.IsOver()) {
     cpt++;
 
     if (kbhit()) {
+      TETRIS_LATENCY_BEGIN();
       int k = rlutil::getkey();  // Get character
+      TETRIS_LATENCY_PROBE(KeyRead);
 
       if (user_input.IsAssignedKey(k)) {
         user_input.OnKeyPressed(k);
-        Draw(game);
+        draw(game);
+        TETRIS_LATENCY_END();
+      } else {
+        TETRIS_LATENCY_CANCEL();
       }
     }
 
     if (timer.Poll()) {
-      Draw(game);
+      draw(game);
     }
-  }
-}
-
-void Draw(const Tetris& game) {
-  rlutil::cls();
-  rlutil::hidecursor();
-
-  const int rl_offset = 2;
-
-  for (auto p : game.LeftWall()) {
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << '#';
-  }
-  for (auto p : game.RightWall()) {
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << '#';
-  }
-  for (auto p : game.Floor()) {
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << '#';
-  }
-  for (auto b : game.StaleBlocks()) {
-    auto p = b.pos;
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << 'x';
-  }
 
-  for (auto p : game.Current().BlocksAbsolutePosition()) {
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << '@';
-  }
-
-  // print next
-  gotoxy(15, 6);
-  std::cout << "next: ";
-  auto next = game.Next();
-  next.SetX(22);
-  next.SetY(6);
-  for (auto p : next.BlocksAbsolutePosition()) {
-    gotoxy(p.x + rl_offset, p.y);
-    std::cout << '@';
-  }
-
-  gotoxy(15, 12);
-  std::cout << "score: " << game.Scoring().Score();
-  gotoxy(15, 13);
-  std::cout << "lines: " << game.Scoring().CompletedLines();
-  gotoxy(15, 14);
-  std::cout << "level: " << game.Scoring().Level();
-
-  if (game.IsPause()) {
-    gotoxy(15, 18);
-
-    std::cout << "press <Enter> to start";
+#if defined(TETRIS_WITH_LATENCY_PROBES)
+    if (dump_latency) {
+      dump_latency = 0;
+      LatencyTracer::Instance().Dump(std::cerr);
+    }
+#endif
   }
 
-  std::cout.flush();
-}
\ No newline at end of file
+#if defined(TETRIS_WITH_LATENCY_PROBES)
+  LatencyTracer::Instance().Dump(std::cerr);
+#endif
+}
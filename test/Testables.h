@@ -5,8 +5,10 @@ using namespace tetris;
 
 struct TestableTimer : public ITimer {
   int start_call{};
-  void Start(const std::chrono::milliseconds& period) {
+  std::chrono::milliseconds period{};
+  void Start(const std::chrono::milliseconds& period_p) {
     start_call++;
+    period = period_p;
     started = true;
   }
   void Stop() { started = false; }
@@ -27,10 +29,18 @@ struct TetrisTestable : public Tetris {
     Tetris::OnRotate();
     input_event += 100;
   }
+  void OnReverseRotate() override {
+    Tetris::OnReverseRotate();
+    input_event += 10000000;
+  }
   void OnFastDown() override {
     Tetris::OnFastDown();
     input_event += 1000;
   }
+  void OnHardDrop() override {
+    Tetris::OnHardDrop();
+    input_event += 1000000;
+  }
   void OnPause() override {
     Tetris::OnPause();
     input_event += 10000;
@@ -0,0 +1,152 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/TetrisBatch.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+namespace {
+
+std::vector<eBatchAction> RandomActions(int nb_games, std::mt19937& gen) {
+  std::uniform_int_distribution<int> dist(0, static_cast<int>(eBatchAction::Count) - 1);
+  std::vector<eBatchAction> actions(nb_games);
+  for (auto& action : actions)
+    action = static_cast<eBatchAction>(dist(gen));
+  return actions;
+}
+
+}  // namespace
+
+TEST_CASE("batch construction") {
+  TetrisBatch batch(8, 42, BoardSize{10, 20}, 3);
+  REQUIRE(batch.Size() == 8);
+  REQUIRE(batch.Width() == 10);
+  REQUIRE(batch.Height() == 20);
+
+  for (int g = 0; g < batch.Size(); g++) {
+    REQUIRE_FALSE(batch.IsOver(g));
+    REQUIRE(batch.Score(g) == 1);
+    REQUIRE(batch.Current(g).Position() == Pos{5, 0});
+    for (int y = 0; y < batch.Height(); y++)
+      REQUIRE(batch.RowMask(g, y) == 0);
+  }
+  REQUIRE_THROWS_AS(batch.Next(0, 3), std::runtime_error);
+
+  REQUIRE_THROWS_AS(TetrisBatch(0, 1), std::runtime_error);
+  REQUIRE_THROWS_AS(TetrisBatch(1, 1, BoardSize{17, 20}), std::runtime_error);
+  REQUIRE_THROWS_AS(TetrisBatch(1, 1, BoardSize{10, 65}), std::runtime_error);
+  REQUIRE_THROWS_AS(batch.Step(std::vector<eBatchAction>(7)), std::runtime_error);
+}
+
+TEST_CASE("batch is deterministic") {
+  TetrisBatch a(16, 7);
+  TetrisBatch b(16, 7);
+  std::mt19937 gen(std::random_device{}());
+  for (int step = 0; step < 500; step++) {
+    auto actions = RandomActions(a.Size(), gen);
+    a.Step(actions);
+    b.Step(actions);
+  }
+  for (int g = 0; g < a.Size(); g++) {
+    REQUIRE(a.Score(g) == b.Score(g));
+    for (int y = 0; y < a.Height(); y++)
+      REQUIRE(a.RowMask(g, y) == b.RowMask(g, y));
+  }
+}
+
+TEST_CASE("batch actions") {
+  TetrisBatch batch(2, 3);
+  const auto start = batch.Current(0).Position();
+
+  batch.Step({eBatchAction::Left, eBatchAction::None});
+  REQUIRE(batch.Current(0).Position() == Pos{start.x - 1, start.y + 1});
+  REQUIRE(batch.Current(1).Position() == Pos{start.x, start.y + 1});
+  REQUIRE(batch.Reward(0) == 0);
+
+  SECTION("hard drop locks and scores 2 points per cell") {
+    const int distance = batch.DropDistance(1);
+    const auto next = batch.Next(1);
+    batch.Step({eBatchAction::None, eBatchAction::HardDrop});
+    REQUIRE(batch.Reward(1) == 2 * distance + 1);
+    REQUIRE(batch.RowMask(1, batch.Height() - 1) != 0);
+    REQUIRE(batch.Current(1).Type() == next);
+    REQUIRE(batch.Current(1).Position() == start);
+  }
+
+  SECTION("game over freezes the game until reset") {
+    std::vector<eBatchAction> drop{eBatchAction::HardDrop, eBatchAction::None};
+    while (!batch.IsOver(0))
+      batch.Step(drop);
+    const int score = batch.Score(0);
+    batch.Step(drop);
+    REQUIRE(batch.Score(0) == score);
+    REQUIRE(batch.Reward(0) == 0);
+
+    batch.Reset(0, 3);
+    REQUIRE_FALSE(batch.IsOver(0));
+    REQUIRE(batch.Score(0) == 1);
+    REQUIRE_FALSE(batch.IsOver(1));
+  }
+}
+
+TEST_CASE("batch plays like the engine") {
+  const BoardSize size{8, 12};
+  const int preview = 60;
+  const auto seed = std::random_device{}();
+  TetrisBatch batch(1, seed, size, preview);
+
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  gen.buf.push_back(batch.Current(0));
+  for (int offset = 0; offset < preview; offset++)
+    gen.buf.push_back(Tetriminos{batch.Next(0, offset)});
+  TetrisTestable game(user_input, timer, score, gen, 1, size);
+  InputListener& input = game;
+  input.OnResume();
+
+  std::mt19937 rand(seed);
+  int landed = 0;
+  for (int step = 0; step < 2000 && landed < preview - 2 && !batch.IsOver(0); step++) {
+    INFO("seed " << seed << " step " << step);
+    const auto actions = RandomActions(1, rand);
+    batch.Step(actions);
+
+    const auto history_size = game.History().size();
+    switch (actions[0]) {
+      case eBatchAction::Left:
+        input.OnLeft();
+        break;
+      case eBatchAction::Right:
+        input.OnRight();
+        break;
+      case eBatchAction::Rotate:
+        input.OnRotate();
+        break;
+      case eBatchAction::ReverseRotate:
+        input.OnReverseRotate();
+        break;
+      case eBatchAction::SoftDrop:
+        input.OnFastDown();
+        break;
+      case eBatchAction::HardDrop:
+        input.OnHardDrop();
+        break;
+      default:
+        break;
+    }
+    const auto& history = game.History();
+    if (std::find(history.begin() + history_size, history.end(), eAction::Land) == history.end())
+      timer.Step();
+    landed += std::count(history.begin() + history_size, history.end(), eAction::Land);
+
+    REQUIRE(batch.Current(0).Type() == game.Current().Type());
+    REQUIRE(batch.Current(0).Position() == game.Current().Position());
+    REQUIRE(batch.Current(0).Rotation() == game.Current().Rotation());
+    for (int y = 0; y < size.height; y++)
+      REQUIRE(batch.RowMask(0, y) == game.Playfield().RowMask(y));
+  }
+  REQUIRE(batch.IsOver(0) == game.IsOver());
+}
@@ -0,0 +1,202 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/Board.h>
+#include <Tetris/Tetris.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+TEST_CASE("board rows are bitmasks") {
+  Board board;
+  REQUIRE(board.Size() == BoardSize{10, 25});
+  REQUIRE(board.IsEmpty());
+  REQUIRE(board.FullRow() == 0x3ff);
+
+  board.Set(Pos{3, 5}, Tetriminos::eColor::Red);
+  REQUIRE(board.RowMask(5) == 1 << 3);
+  REQUIRE(board.IsOccupied(Pos{3, 5}));
+  REQUIRE(board.Color(Pos{3, 5}) == Tetriminos::eColor::Red);
+
+  SECTION("cells out of the board are free") {
+    REQUIRE_FALSE(board.IsOccupied(Pos{3, -1}));
+    REQUIRE_FALSE(board.IsOccupied(Pos{-1, 5}));
+    REQUIRE_FALSE(board.IsOccupied(Pos{10, 5}));
+  }
+
+  SECTION("rows above a line drop with their colors") {
+    board.DropRowsAbove(7);
+    REQUIRE(board.RowMask(5) == 0);
+    REQUIRE(board.IsOccupied(Pos{3, 6}));
+    REQUIRE(board.Color(Pos{3, 6}) == Tetriminos::eColor::Red);
+  }
+
+  SECTION("columns follow rows") {
+    REQUIRE(board.ColumnMask(3) == 1 << 5);
+    REQUIRE(board.FreeCellsBelow(Pos{3, 0}) == 4);
+    REQUIRE(board.FreeCellsBelow(Pos{3, 6}) == 18);
+    REQUIRE(board.FreeCellsBelow(Pos{3, -2}) == 6);
+
+    board.DropRowsAbove(9);
+    REQUIRE(board.ColumnMask(3) == 1 << 6);
+
+    board.ClearRow(6);
+    REQUIRE(board.ColumnMask(3) == 0);
+    REQUIRE(board.FreeCellsBelow(Pos{3, 0}) == 24);
+  }
+
+  SECTION("iterate on blocks") {
+    board.Set(Pos{9, 24}, Tetriminos::eColor::Blue);
+    std::vector<Pos> blocks;
+    board.ForEachBlock([&blocks](const Pos& pos, Tetriminos::eColor) { blocks.push_back(pos); });
+    REQUIRE(blocks == std::vector<Pos>{Pos{3, 5}, Pos{9, 24}});
+  }
+}
+
+TEMPLATE_TEST_CASE("rows pushed up from the bottom", "", Board, (BasicBoard<10, 25>)) {
+  TestType board{BoardSize{10, 25}};
+  board.Set(Pos{3, 5}, Tetriminos::eColor::Red);
+  board.Set(Pos{0, 24}, Tetriminos::eColor::Blue);
+
+  REQUIRE_FALSE(board.PushRowsUp(2, 0x3fe, Tetriminos::eColor::Gray));
+  REQUIRE(board.RowMask(3) == 1 << 3);
+  REQUIRE(board.Color(Pos{3, 3}) == Tetriminos::eColor::Red);
+  REQUIRE(board.RowMask(22) == 1);
+  REQUIRE(board.RowMask(23) == 0x3fe);
+  REQUIRE(board.RowMask(24) == 0x3fe);
+  REQUIRE(board.Color(Pos{1, 24}) == Tetriminos::eColor::Gray);
+  REQUIRE(board.ColumnMask(0) == 1u << 22);
+  REQUIRE(board.ColumnMask(1) == 3u << 23);
+  REQUIRE(board.ColumnMask(3) == (1u << 3 | 3u << 23));
+
+  SECTION("line clears see the pushed rows") {
+    board.ClearRow(23);
+    board.DropRowsAbove(23);
+    REQUIRE(board.RowMask(4) == 1 << 3);
+    REQUIRE(board.RowMask(23) == 1);
+    REQUIRE(board.Color(Pos{0, 23}) == Tetriminos::eColor::Blue);
+    REQUIRE(board.ColumnMask(0) == 1u << 23);
+    REQUIRE(board.ColumnMask(1) == 1u << 24);
+
+    std::vector<Pos> blocks;
+    board.ForEachBlock([&blocks](const Pos& pos, Tetriminos::eColor) { blocks.push_back(pos); });
+    REQUIRE(blocks.size() == 1 + 1 + 9);
+  }
+
+  SECTION("cells pushed over the ceiling are lost") {
+    REQUIRE(board.PushRowsUp(4, 0x3fe, Tetriminos::eColor::Gray));
+    REQUIRE(board.IsOccupied(Pos{3, -1}) == false);
+    REQUIRE(board.ColumnMask(3) == 0x3fu << 19);
+  }
+
+  SECTION("the whole playfield can be pushed") {
+    REQUIRE(board.PushRowsUp(30, 0x3fe, Tetriminos::eColor::Gray));
+    for (int y = 0; y < board.Height(); y++)
+      REQUIRE(board.RowMask(y) == 0x3fe);
+    REQUIRE(board.ColumnMask(0) == 0);
+  }
+}
+
+namespace {
+
+template <class B>
+uint64_t HashOfCells(const B& board) {
+  uint64_t hash = 0;
+  board.ForEachBlock(
+      [&hash](const Pos& pos, Tetriminos::eColor) { hash ^= zobrist::CellKey(pos.x, pos.y); });
+  return hash;
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("zobrist hash follows the cells", "", Board, (BasicBoard<10, 25>)) {
+  TestType board{BoardSize{10, 25}};
+  REQUIRE(board.Hash() == 0);
+  board.Set(Pos{3, 5}, Tetriminos::eColor::Red);
+  board.Set(Pos{3, 5}, Tetriminos::eColor::Blue);  // already occupied
+  for (int x = 0; x < 10; x++)
+    board.Set(Pos{x, 20}, Tetriminos::eColor::Green);
+  board.Set(Pos{7, 21}, Tetriminos::eColor::Red);
+  const uint64_t before_clear = board.Hash();
+  REQUIRE(before_clear == HashOfCells(board));
+
+  board.ClearRow(20);
+  board.DropRowsAbove(20);
+  REQUIRE(board.Hash() == HashOfCells(board));
+  REQUIRE(board.Hash() != before_clear);
+
+  board.PushRowsUp(3, 0x3fe, Tetriminos::eColor::Gray);
+  REQUIRE(board.Hash() == HashOfCells(board));
+  board.Set(Pos{2, 1}, Tetriminos::eColor::Red);
+  REQUIRE(board.PushRowsUp(2, 0x1ff, Tetriminos::eColor::Gray));  // (2,1) is lost
+  REQUIRE(board.Hash() == HashOfCells(board));
+
+  TestType same{BoardSize{10, 25}};
+  board.ForEachBlock([&same](const Pos& pos, Tetriminos::eColor color) { same.Set(pos, color); });
+  REQUIRE(same.Hash() == board.Hash());
+}
+
+TEST_CASE("engine hash of the playfield and the current tetriminos") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  gen.buf = std::list<Tetriminos>(6, Tetriminos{Tetriminos::eType::T});
+  TetrisTestable game(user_input, timer, score, gen, 3);
+  InputListener& input = game;
+  input.OnResume();
+
+  const uint64_t start = game.Hash();
+  input.OnLeft();
+  REQUIRE(game.Hash() != start);
+  input.OnRight();
+  REQUIRE(game.Hash() == start);
+  input.OnRotate();
+  REQUIRE(game.Hash() != start);
+
+  input.OnHardDrop();
+  REQUIRE(game.Playfield().Hash() == HashOfCells(game.Playfield()));
+  REQUIRE(game.Hash() == (game.Playfield().Hash() ^ zobrist::PieceKey(game.Current())));
+}
+
+TEST_CASE("runtime board size is limited to 64 columns") {
+  REQUIRE(Board{BoardSize{64, 30}}.FullRow() == ~uint64_t{0});
+  REQUIRE_THROWS_AS((Board{BoardSize{65, 30}}), std::runtime_error);
+  REQUIRE_THROWS_AS((Board{BoardSize{10, 0}}), std::runtime_error);
+}
+
+TEST_CASE("compile time board uses exact width rows") {
+  STATIC_REQUIRE(sizeof(BasicBoard<10, 20>::Row) == 2);
+  STATIC_REQUIRE(sizeof(BasicBoard<32, 20>::Row) == 4);
+  STATIC_REQUIRE(sizeof(BasicBoard<40, 20>::Row) == 8);
+  STATIC_REQUIRE(BasicBoard<10, 40>::Height() == 40);
+
+  REQUIRE_THROWS_AS((BasicBoard<10, 20>{BoardSize{10, 25}}), std::runtime_error);
+}
+
+TEST_CASE("engine playfield size can be customized") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TetriminosGenerator gen(12345);
+
+  SECTION("at runtime") {
+    Tetris game(user_input, timer, score, gen, 1, BoardSize{40, 30});
+    REQUIRE(game.Width() == 40);
+    REQUIRE(game.Height() == 30);
+    REQUIRE(game.StartPosition() == Pos{20, 0});
+    REQUIRE(game.Floor().size() == 42);
+  }
+
+  SECTION("at compile time") {
+    FixedSizeTetris<10, 20> game(user_input, timer, score, gen, 1);
+    REQUIRE(game.Width() == 10);
+    REQUIRE(game.Height() == 20);
+
+    InputListener& input = game;
+    input.OnResume();
+    while (game.Playfield().IsEmpty())
+      timer.Step();
+    REQUIRE(game.StaleBlocks().size() == 4);
+  }
+}
@@ -0,0 +1,139 @@
+#include <catch2/catch.hpp>
+
+#include <CApi/tetris_c.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+using GamePtr = std::unique_ptr<tetris_game, decltype(&tetris_destroy)>;
+
+GamePtr Create(uint32_t seed) {
+  return GamePtr{tetris_create(10, 20, 2, seed), &tetris_destroy};
+}
+}  // namespace
+
+TEST_CASE("c api game life cycle") {
+  REQUIRE(tetris_create(3, 20, 1, 0) == nullptr);
+  REQUIRE(tetris_create(10, 20, 0, 0) == nullptr);
+
+  auto game = Create(12);
+  REQUIRE(game);
+  REQUIRE(tetris_observation_size(game.get(), TETRIS_OBSERVATION_BYTES) == 2 * 10 * 20 + 7 * 3);
+  REQUIRE(tetris_observation_size(game.get(), TETRIS_OBSERVATION_BITS) == (2 * 10 * 20 + 7 * 3 + 7) / 8);
+  REQUIRE(tetris_observation_size(game.get(), 2) == 0);
+  REQUIRE(tetris_score(game.get()) == 1);
+
+  int32_t reward = -1;
+  int32_t done = -1;
+  REQUIRE(tetris_step(game.get(), TETRIS_ACTION_HARD_DROP, &reward, &done) == 0);
+  REQUIRE(reward > 0);
+  REQUIRE(done == 0);
+  REQUIRE(tetris_step(game.get(), TETRIS_ACTION_COUNT, &reward, &done) == -1);
+  REQUIRE(tetris_step(nullptr, TETRIS_ACTION_NONE, nullptr, nullptr) == -1);
+
+  while (!done)
+    tetris_step(game.get(), TETRIS_ACTION_HARD_DROP, &reward, &done);
+  REQUIRE(tetris_step(game.get(), TETRIS_ACTION_LEFT, &reward, &done) == 0);
+  REQUIRE(reward == 0);
+  REQUIRE(done == 1);
+
+  tetris_reset(game.get(), 12);
+  REQUIRE(tetris_score(game.get()) == 1);
+  REQUIRE(tetris_lines(game.get()) == 0);
+}
+
+TEST_CASE("c api observation") {
+  auto game = Create(5);
+  std::vector<uint8_t> obs(tetris_observation_size(game.get(), TETRIS_OBSERVATION_BYTES), 0xFF);
+  REQUIRE(tetris_observe(game.get(), TETRIS_OBSERVATION_BYTES, obs.data()) == 0);
+
+  const auto board_end = obs.begin() + 10 * 20;
+  const auto current_end = board_end + 10 * 20;
+  REQUIRE(std::count(obs.begin(), board_end, 1) == 0);
+  REQUIRE(std::count(board_end, current_end, 1) <= 4);  // may be above the ceiling
+  REQUIRE(std::count(current_end, obs.end(), 1) == 3);  // current and 2 previews
+  REQUIRE(std::count(obs.begin(), obs.end(), 0xFF) == 0);
+
+  tetris_step(game.get(), TETRIS_ACTION_HARD_DROP, nullptr, nullptr);
+  tetris_observe(game.get(), TETRIS_OBSERVATION_BYTES, obs.data());
+  REQUIRE(std::count(obs.begin(), board_end, 1) == 4);
+}
+
+TEST_CASE("c api batch step") {
+  std::vector<GamePtr> owners;
+  std::vector<tetris_game*> games;
+  for (uint32_t seed = 0; seed < 4; seed++) {
+    owners.push_back(Create(seed));
+    games.push_back(owners.back().get());
+  }
+  auto single = Create(2);
+
+  const size_t size = tetris_observation_size(games[0], TETRIS_OBSERVATION_BITS);
+  std::vector<uint8_t> observations(games.size() * size);
+  std::vector<int32_t> rewards(games.size());
+  std::vector<int32_t> dones(games.size());
+  std::vector<int32_t> actions(games.size(), TETRIS_ACTION_SOFT_DROP);
+
+  for (int step = 0; step < 30; step++) {
+    REQUIRE(tetris_step_batch(games.data(), games.size(), actions.data(), rewards.data(),
+                              dones.data(), TETRIS_OBSERVATION_BITS, observations.data()) == 0);
+    int32_t reward = 0;
+    tetris_step(single.get(), TETRIS_ACTION_SOFT_DROP, &reward, nullptr);
+    REQUIRE(rewards[2] == reward);
+  }
+
+  std::vector<uint8_t> obs(size);
+  tetris_observe(single.get(), TETRIS_OBSERVATION_BITS, obs.data());
+  REQUIRE(std::equal(obs.begin(), obs.end(), observations.begin() + 2 * size));
+
+  actions[1] = -1;
+  REQUIRE(tetris_step_batch(games.data(), games.size(), actions.data(), nullptr, nullptr,
+                            TETRIS_OBSERVATION_BYTES, nullptr) == -1);
+}
+
+TEST_CASE("c api batch handle") {
+  using BatchPtr = std::unique_ptr<tetris_batch, decltype(&tetris_batch_destroy)>;
+  REQUIRE(tetris_batch_create(0, 10, 20, 2, 5) == nullptr);
+  REQUIRE(tetris_batch_create(4, 3, 20, 2, 5) == nullptr);
+  BatchPtr batch{tetris_batch_create(4, 10, 20, 2, 5), &tetris_batch_destroy};
+  REQUIRE(batch);
+  REQUIRE(tetris_batch_size(batch.get()) == 4);
+  auto single = Create(5);  // same tetriminos as game 0
+
+  const size_t size = tetris_batch_observation_size(batch.get(), TETRIS_OBSERVATION_BYTES);
+  REQUIRE(size == tetris_observation_size(single.get(), TETRIS_OBSERVATION_BYTES));
+  std::vector<uint8_t> observations(4 * size);
+  std::vector<int32_t> rewards(4);
+  std::vector<int32_t> dones(4);
+  const std::vector<int32_t> actions{TETRIS_ACTION_HARD_DROP, TETRIS_ACTION_LEFT,
+                                     TETRIS_ACTION_ROTATE, TETRIS_ACTION_NONE};
+
+  int32_t total = 0;
+  for (int step = 0; step < 30; step++) {
+    REQUIRE(tetris_batch_step(batch.get(), actions.data(), rewards.data(), dones.data(),
+                              TETRIS_OBSERVATION_BYTES, observations.data()) == 0);
+    int32_t reward = 0;
+    int32_t done = 0;
+    tetris_step(single.get(), TETRIS_ACTION_HARD_DROP, &reward, &done);
+    REQUIRE(rewards[0] == reward);
+    REQUIRE(dones[0] == done);
+    total += reward;
+  }
+  REQUIRE(total + 1 == tetris_score(single.get()));  // first tetriminos counted on creation
+
+  std::vector<uint8_t> obs(size);
+  tetris_observe(single.get(), TETRIS_OBSERVATION_BYTES, obs.data());
+  REQUIRE(std::equal(obs.begin(), obs.end(), observations.begin()));
+
+  REQUIRE(tetris_batch_reset(batch.get(), 4, 0) == -1);
+  REQUIRE(tetris_batch_reset(batch.get(), 0, 5) == 0);
+  REQUIRE(tetris_batch_step(batch.get(), actions.data(), nullptr, dones.data(),
+                            TETRIS_OBSERVATION_BYTES, nullptr) == 0);
+  REQUIRE(dones[0] == 0);
+  std::vector<int32_t> invalid(actions);
+  invalid[3] = TETRIS_ACTION_COUNT;
+  REQUIRE(tetris_batch_step(batch.get(), invalid.data(), nullptr, nullptr,
+                            TETRIS_OBSERVATION_BYTES, nullptr) == -1);
+}
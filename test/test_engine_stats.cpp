@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/Tetris.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+TEST_CASE("production engine does not carry stats") {
+  STATIC_REQUIRE(std::is_empty<Tetris::Stats>::value);
+}
+
+struct ProfiledTestable : ProfiledTetris {
+  using ProfiledTetris::ProfiledTetris;
+  using ProfiledTetris::AddStaleBlock;
+};
+
+TEST_CASE("profiled engine counts operations") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::I}, Tetriminos{t::I}, Tetriminos{t::I}};
+
+  ProfiledTestable game(user_input, timer, score, gen, 1);
+  InputListener& input = game;
+  const auto& stats = game.Statistics();
+
+  REQUIRE(stats.Counter(eEngineCounter::PieceSpawned) == 1);
+
+  SECTION("nothing is counted on pause") {
+    input.OnLeft();
+    REQUIRE(stats.Counter(eEngineCounter::CollisionStaleBlocks) == 0);
+    REQUIRE(stats.Timings(eEngineOperation::Left).calls == 0);
+  }
+
+  SECTION("collision checks are counted by kind") {
+    input.OnResume();
+    input.OnLeft();
+    REQUIRE(stats.Counter(eEngineCounter::CollisionStaleBlocks) == 1);
+    REQUIRE(stats.Counter(eEngineCounter::CollisionLeftWall) == 1);
+    REQUIRE(stats.Counter(eEngineCounter::CollisionRightWall) == 0);
+
+    input.OnRight();
+    REQUIRE(stats.Counter(eEngineCounter::CollisionStaleBlocks) == 2);
+    REQUIRE(stats.Counter(eEngineCounter::CollisionRightWall) == 1);
+
+    REQUIRE(stats.Timings(eEngineOperation::Left).calls == 1);
+    REQUIRE(stats.Timings(eEngineOperation::Right).calls == 1);
+    REQUIRE(stats.Timings(eEngineOperation::Right).min <= stats.Timings(eEngineOperation::Right).max);
+  }
+
+  SECTION("rejected rotations are counted") {
+    input.OnResume();
+    for (int i = 0; i < 10; i++)
+      input.OnFastDown();
+    const int w = game.Width() / 2;  // block the rotation and its 4 kicks
+    for (auto pos : {Pos{w + 2, 11}, Pos{w, 11}, Pos{w + 3, 9}})
+      game.AddStaleBlock(Block{pos, Tetriminos::eColor::Blue});
+    input.OnRotate();
+    REQUIRE(stats.Counter(eEngineCounter::RotationRejected) == 1);
+    REQUIRE(stats.Counter(eEngineCounter::CollisionFloor) > 0);
+  }
+
+  SECTION("clears and gravity passes are counted") {
+    input.OnResume();
+    for (int i = 0; i < 2; i++) {
+      for (int x = 0; x < game.Width(); x++) {
+        if (x < 5 || x > 8)
+          game.AddStaleBlock(Block{Pos{x, game.Height() - 1 - i}, Tetriminos::eColor::Blue});
+      }
+    }
+    game.AddStaleBlock(Block{Pos{0, game.Height() - 3}, Tetriminos::eColor::Blue});
+
+    while (stats.Counter(eEngineCounter::PieceSpawned) == 1)
+      input.OnFastDown();
+
+    REQUIRE(stats.Clears(1) == 1);
+    REQUIRE(stats.Clears(2) == 0);
+    REQUIRE(stats.Counter(eEngineCounter::GravityPass) == 1);
+    REQUIRE(stats.Timings(eEngineOperation::Land).calls == 1);
+  }
+
+  SECTION("stats are exported as json") {
+    input.OnResume();
+    input.OnLeft();
+    auto json = stats.ToJson();
+    REQUIRE(json.front() == '{');
+    REQUIRE(json.back() == '}');
+    REQUIRE(json.find("\"collision_left_wall\":1") != std::string::npos);
+    REQUIRE(json.find("\"left\":{\"calls\":1") != std::string::npos);
+    REQUIRE(json.find("\"lines_cleared\":{\"1\":0") != std::string::npos);
+  }
+}
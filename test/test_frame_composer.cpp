@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/FrameComposer.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "Testables.h"
+
+using namespace tetris;
+
+TEST_CASE("console frame composer") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::T}};
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.AddStaleBlocks({Pos{0, 24}, Pos{9, 24}});
+
+  FrameComposer composer(game.Playfield().Size());
+  const std::string& frame = composer.Compose(game);
+  const auto* data = frame.data();
+  const size_t size = frame.size();
+
+  REQUIRE(frame.substr(0, 3) == "\x1b[H");
+  REQUIRE(composer.Line(0).substr(0, 12) == "#     @@   #");
+  REQUIRE(composer.Line(23).substr(0, 12) == "#     ..   #");
+  REQUIRE(composer.Line(24).substr(0, 12) == "#x    ..  x#");
+  REQUIRE(composer.Line(25).substr(0, 12) == "############");
+  REQUIRE(composer.Line(FrameComposer::kScoreRow).substr(14, 9) == "score: 0 ");
+  REQUIRE(composer.Line(FrameComposer::kPauseRow).substr(14) == "press <Enter> to start  ");
+  REQUIRE(composer.Line(FrameComposer::kNextRow).find('@') != std::string::npos);
+  const auto first = composer.Rendered();
+
+  SECTION("nothing changed, nothing rendered") {
+    composer.Compose(game);
+    REQUIRE(composer.Rendered().playfield == first.playfield);
+    REQUIRE(composer.Rendered().numbers == first.numbers);
+    REQUIRE(composer.Rendered().preview == first.preview);
+  }
+
+  SECTION("a move renders the playfield only") {
+    InputListener& input = game;
+    input.OnResume();
+    input.OnLeft();
+    composer.Compose(game);
+    REQUIRE(composer.Rendered().playfield == first.playfield + 1);
+    REQUIRE(composer.Rendered().numbers == first.numbers);
+    REQUIRE(composer.Line(0).substr(0, 12) == "#    @@    #");
+    const auto pause_line = composer.Line(FrameComposer::kPauseRow).substr(14);
+    REQUIRE(pause_line.find_first_not_of(' ') == std::string::npos);
+  }
+
+  SECTION("numbers are rendered when they change") {
+    score.compteted_lines = 12345;
+    composer.Compose(game);
+    REQUIRE(composer.Rendered().numbers == first.numbers + 2);  // lines and level
+    REQUIRE(composer.Line(FrameComposer::kLinesRow).substr(14, 13) == "lines: 12345 ");
+    REQUIRE(composer.Line(FrameComposer::kLevelRow).substr(14, 13) == "level: 1235  ");
+    score.compteted_lines = 7;
+    composer.Compose(game);
+    REQUIRE(composer.Line(FrameComposer::kLinesRow).substr(14, 13) == "lines: 7     ");
+  }
+
+#if !defined(_WIN32)
+  SECTION("the frame is written at once, in place") {
+    game.AddStaleBlocks({Pos{4, 20}});
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    REQUIRE(composer.Draw(game, fds[1]));
+    std::string written(size, '\0');
+    REQUIRE(read(fds[0], &written[0], size) == static_cast<ssize_t>(size));
+    close(fds[0]);
+    close(fds[1]);
+    REQUIRE(written == composer.Frame());
+    REQUIRE(composer.Frame().data() == data);
+    REQUIRE(composer.Frame().size() == size);
+    REQUIRE(composer.Line(20).substr(0, 12) == "#    x     #");
+  }
+#endif
+}
+
+TEST_CASE("colored console frame") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::T}};
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.AddStaleBlocks({Pos{0, 24}, Pos{9, 24}});  // blue
+
+  FrameComposer mono(game.Playfield().Size());
+  FrameComposer composer(game.Playfield().Size(), true);
+  const std::string& plain = mono.Compose(game);
+  const std::string& frame = composer.Compose(game);
+  const auto* data = frame.data();
+
+  const auto strip = [](std::string text) {
+    for (auto i = text.find("\x1b[", 1); i != std::string::npos; i = text.find("\x1b[", i))
+      text.erase(i, 5);
+    return text;
+  };
+  const auto count = [](const std::string& text, const std::string& pattern) {
+    size_t n = 0;
+    for (auto i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1))
+      n++;
+    return n;
+  };
+
+  SECTION("same cells as the monochrome frame") {
+    REQUIRE(strip(frame) == plain);
+    REQUIRE(composer.Line(24) == mono.Line(24));
+  }
+
+  SECTION("colors are emitted on transitions only") {
+    // O is yellow, blanks do not end a run
+    REQUIRE(frame.substr(0, 25) == "\x1b[H#     \x1b[93m@@   \x1b[39m#");
+    REQUIRE(frame.find("#\x1b[94mx    \x1b[93m..  \x1b[94mx\x1b[39m#") != std::string::npos);
+    // walls are uncolored: rows 0, 1, 23 and the preview (I is cyan) have a color and the
+    // default, row 24 blue, yellow, blue and the default
+    REQUIRE(count(frame, "\x1b[") - 1 == 4 * 2 + 4);
+    REQUIRE(count(frame, "\x1b[96m") == 1);
+    REQUIRE(frame.size() < plain.size() + plain.size() / 10);
+  }
+
+  SECTION("a full row of one color is a single run") {
+    for (int x = 1; x < 9; x++)
+      game.AddStaleBlocks({Pos{x, 24}});
+    composer.Compose(game);
+    REQUIRE(count(frame, "\x1b[94m") == 1);
+    REQUIRE(frame.rfind("\x1b[") == frame.rfind("\x1b[39m"));  // next frame starts uncolored
+    REQUIRE(frame.data() == data);
+  }
+
+  SECTION("nothing changed, nothing colored") {
+    const std::string before = frame;
+    const auto first = composer.Rendered();
+    REQUIRE(first.colored == 1);
+    composer.Compose(game);
+    REQUIRE(composer.Rendered().colored == first.colored);
+    REQUIRE(frame == before);
+    InputListener& input = game;
+    input.OnResume();  // the pause line is cleared
+    composer.Compose(game);
+    REQUIRE(composer.Rendered().colored == first.colored + 1);
+    REQUIRE(strip(frame) == mono.Compose(game));
+  }
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/Gravity.h>
+#include <Tetris/NintendoClassicScore.h>
+#include <Tetris/Tetris.h>
+#include <Tetris/VirtualTimer.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+using namespace std::literals::chrono_literals;
+
+TEST_CASE("gravity fixed point") {
+  STATIC_REQUIRE(Gravity::FromG(1).per_frame == Gravity::kCell);
+  STATIC_REQUIRE(Gravity::FromPeriod(0ms) == Gravity::Max());
+  STATIC_REQUIRE(Gravity::FromPeriod(1s) == Gravity::FromFramesPerCell(60));
+  STATIC_REQUIRE(FramesOf(500ms) == 30);
+  STATIC_REQUIRE(FramesOf(1ms) == 1);
+
+  SECTION("a cell every n frames, exactly") {
+    for (int frames : {1, 2, 3, 48, 60}) {
+      const auto g = Gravity::FromFramesPerCell(frames);
+      REQUIRE(int64_t{g.per_frame} * frames >= Gravity::kCell);
+      REQUIRE(int64_t{g.per_frame} * (frames - 1) < Gravity::kCell);
+    }
+  }
+
+  SECTION("nintendo gravity is not truncated to milliseconds") {
+    NintendoClassicScore score;
+    REQUIRE(score.GravityPerFrame() == Gravity::FromG(0.01667));
+    REQUIRE(score.GravityPerFrame(19) == Gravity::FromG(20));
+  }
+}
+
+struct FrameScore : DummyScore {
+  Gravity gravity = Gravity::FromFramesPerCell(10);
+  Gravity GravityPerFrame(int level) const override { return gravity; }
+};
+
+TEST_CASE("frame driven game") {
+  VirtualTimer timer;  // never advanced
+  UserInput user_input;
+  FrameScore score;
+  TestableGenerator gen;
+  for (int i = 0; i < 100; i++)
+    gen.buf.push_back(Tetriminos{Tetriminos::eType::O});
+
+  SECTION("gravity accumulates frame after frame") {
+    TetrisTestable game(user_input, timer, score, gen, 1);
+    REQUIRE(game.AdvanceFrames(10) == 0);  // paused
+    game.OnResume();
+
+    REQUIRE(game.AdvanceFrames(9) == 9);
+    REQUIRE(game.Current().Position().y == 0);
+    game.AdvanceFrames(1);
+    REQUIRE(game.Current().Position().y == 1);
+    game.AdvanceFrames(50);
+    REQUIRE(game.Current().Position().y == 6);
+    REQUIRE(game.Frame() == 60);
+  }
+
+  SECTION("20G falls 20 cells per frame") {
+    score.gravity = Gravity::Max();
+    TetrisTestable game(user_input, timer, score, gen, 1);
+    game.SetLockDelay(LockDelay::MoveReset(500ms));
+    game.OnResume();
+    const auto landing = game.Ghost().Position();
+
+    game.AdvanceFrames(1);
+    REQUIRE(game.Current().Position().y == 20);
+    game.AdvanceFrames(1);
+    REQUIRE(game.Current().Position() == landing);
+    REQUIRE(game.IsLocking());
+
+    SECTION("lock delay counts frames") {
+      game.AdvanceFrames(29);
+      REQUIRE(game.IsLocking());
+      game.AdvanceFrames(1);
+      REQUIRE(game.LastAction() == eAction::Land);
+    }
+
+    SECTION("a move restarts the delay") {
+      game.AdvanceFrames(20);
+      game.OnLeft();
+      game.AdvanceFrames(29);
+      REQUIRE(game.IsLocking());
+      game.AdvanceFrames(1);
+      REQUIRE(game.LastAction() == eAction::Land);
+    }
+  }
+
+  SECTION("batches stop on game over") {
+    TetrisTestable game(user_input, timer, score, gen, 1);
+    game.OnResume();
+    const int done = game.AdvanceFrames(1000000);
+    REQUIRE(done < 1000000);
+    REQUIRE(game.IsOver());
+    REQUIRE(game.Frame() == done);
+  }
+}
@@ -1,8 +1,10 @@
 #include <catch2/catch.hpp>
 
+#include <Tetris/HeadlessTetris.h>
 #include <Tetris/KeyboardInput.h>
 #include <Tetris/NintendoClassicScore.h>
 #include <Tetris/Tetris.h>
+#include <Tetris/VirtualTimer.h>
 
 #include "Testables.h"
 
@@ -222,10 +224,12 @@ TEST_CASE("during game, current block can move right until stale blocks  ") {
 
   int w = game.Width();
 
+  // stale blocks are on the grid, an I at start position would already touch them
+  game.SetCurrent(Tetriminos{Tetriminos::eType::T});
   game.AddStaleBlocks({
-      Pos{w, 0},
-      Pos{w, 1},
-      Pos{w, 2},
+      Pos{w - 1, 0},
+      Pos{w - 1, 1},
+      Pos{w - 1, 2},
   });
 
   game.OnResume();
@@ -263,6 +267,90 @@ TEST_CASE("during game, current block can be soft drop  ") {
   }
 }
 
+TEST_CASE("during game, current block can be hard dropped") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::I}};
+
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.OnResume();
+
+  SECTION("lands on the floor") {
+    REQUIRE(game.DropDistance() == game.Height() - 2);
+    game.OnHardDrop();
+    REQUIRE(game.History() == ActionHistory{eAction::HardDrop, eAction::Land});
+    REQUIRE(game.Playfield().IsOccupied(Pos{5, game.Height() - 1}));
+    REQUIRE(game.Playfield().IsOccupied(Pos{6, game.Height() - 2}));
+    REQUIRE(game.Current().Type() == t::I);
+  }
+
+  SECTION("lands on the highest stale block under the tetriminos") {
+    game.AddStaleBlocks({Pos{6, 10}, Pos{5, 20}});
+    REQUIRE(game.DropDistance() == 8);
+  }
+
+  SECTION("can fall under an overhang") {
+    game.AddStaleBlocks({Pos{5, 3}});
+    auto o = Tetriminos{t::O};
+    o.SetY(5);
+    game.SetCurrent(o);
+    REQUIRE(game.DropDistance() == game.Height() - 7);
+  }
+
+  SECTION("same landing than repeated soft drop") {
+    game.AddStaleBlocks({Pos{4, 12}, Pos{6, 15}, Pos{7, 9}});
+    const int distance = game.DropDistance();
+    for (int i = 0; i < distance; i++) {
+      game.OnFastDown();
+      REQUIRE(game.LastAction() == eAction::Down);
+    }
+    game.OnFastDown();
+    REQUIRE(game.LastAction() == eAction::Land);
+  }
+}
+
+TEST_CASE("ghost is the landing position of current block") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::I}};
+
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.OnResume();
+
+  REQUIRE(game.Ghost().Type() == t::O);
+  REQUIRE(game.Ghost().Position() == Pos{5, game.Height() - 2});
+
+  SECTION("is the same while falling") {
+    game.OnFastDown();
+    REQUIRE(game.Ghost().Position() == Pos{5, game.Height() - 2});
+  }
+
+  SECTION("follows moves") {
+    game.OnLeft();
+    REQUIRE(game.Ghost().Position() == Pos{4, game.Height() - 2});
+  }
+
+  SECTION("follows playfield changes") {
+    game.AddStaleBlocks({Pos{5, 10}});
+    REQUIRE(game.Ghost().Position() == Pos{5, 8});
+
+    game.ApplyGravity(11);
+    REQUIRE(game.Ghost().Position() == Pos{5, 9});
+  }
+
+  SECTION("follows new tetriminos") {
+    game.OnHardDrop();
+    REQUIRE(game.Ghost().Type() == t::I);
+    REQUIRE(game.Ghost().Position() == Pos{5, game.Height() - 3});
+  }
+}
+
 TEST_CASE("during game, current block can not rotate if collide  ") {
   TestableTimer timer;
   UserInput user_input;
@@ -272,20 +360,53 @@ TEST_CASE("during game, current block can not rotate if collide  ") {
 
   auto w = game.Width() / 2;
 
+  // block the rotation and the 4 kicks of an horizontal I
   game.AddStaleBlocks({
-      Pos{w - 1, 2},
-      Pos{w, 2},
-      Pos{w + 1, 2},
+      Pos{w + 2, 11},
+      Pos{w, 11},
+      Pos{w + 3, 9},
   });
 
   game.OnResume();
 
-  game.SetCurrent(Tetriminos{Tetriminos::eType::I});
+  auto i = Tetriminos{Tetriminos::eType::I};
+  i.SetY(10);
+  game.SetCurrent(i);
 
   game.OnRotate();
   REQUIRE(game.History() == ActionHistory{eAction::TryRotate, eAction::CollisionStale});
 }
 
+TEST_CASE("during game, rotation kicks away from obstacles") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TetriminosGenerator gen(std::random_device{}());
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.OnResume();
+
+  SECTION("against the wall") {
+    auto t = Tetriminos{Tetriminos::eType::T};
+    t.RotateBack();  // nub on the left, stem against the right wall
+    t.SetY(10);
+    game.SetCurrent(t);
+    for (int i = 0; i < game.Width(); i++)
+      game.OnRight();
+    REQUIRE(game.Current().Position().x == game.Width() - 1);
+
+    game.OnRotate();  // L -> 0 does not fit, kick (-1,0)
+    REQUIRE(game.LastAction() == eAction::Rotate);
+    REQUIRE(game.Current().Rotation() == 0);
+    REQUIRE(game.Current().Position() == Pos{game.Width() - 2, 10});
+  }
+
+  SECTION("counter clockwise") {
+    game.OnReverseRotate();
+    REQUIRE(game.LastAction() == eAction::Rotate);
+    REQUIRE(game.Current().Rotation() == 3);
+  }
+}
+
 TEST_CASE("On timer event, tetriminos move down ") {
   TestableTimer timer;
   UserInput user_input;
@@ -434,6 +555,50 @@ TEST_CASE(" can apply gravity when several line were cleared") {
   REQUIRE(game.FindCompletedLines() == std::vector<int>{9, 10, 11});
 }
 
+TEST_CASE("garbage rows push the playfield up") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TetriminosGenerator gen(std::random_device{}());
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.AddStaleBlocks({Pos{0, 24}, Pos{5, 12}});
+
+  game.AddGarbage(2, 3);
+
+  REQUIRE(game.LastAction() == eAction::Garbage);
+  REQUIRE(game.Playfield().RowMask(24) == (game.Playfield().FullRow() & ~(1u << 3)));
+  REQUIRE(game.Playfield().RowMask(23) == game.Playfield().RowMask(24));
+  REQUIRE(game.Playfield().Color(Pos{0, 24}) == Tetriminos::eColor::Gray);
+  REQUIRE(game.Playfield().IsOccupied(Pos{0, 22}));
+  REQUIRE(game.Playfield().IsOccupied(Pos{5, 10}));
+  REQUIRE(game.StaleBlocks().size() == 2 + 2 * 9);
+  REQUIRE(game.IsOver() == false);
+
+  SECTION("hole must be in the playfield") {
+    REQUIRE_THROWS(game.AddGarbage(1, -1));
+    REQUIRE_THROWS(game.AddGarbage(1, game.Width()));
+  }
+
+  SECTION("current tetriminos rises with the stack") {
+    Tetriminos o{Tetriminos::eType::O};
+    o.SetY(8);  // on the block at (5,10)
+    game.SetCurrent(o);
+    game.AddGarbage(1, 0);
+    REQUIRE(game.Current().Position().y == 7);
+    REQUIRE(game.Playfield().IsOccupied(Pos{5, 9}));
+    REQUIRE(game.IsOver() == false);
+  }
+
+  SECTION("stale blocks pushed over the ceiling top out") {
+    game.AddGarbage(9, 0);  // (5,1), the current tetriminos may rise on it
+    REQUIRE(game.IsOver() == false);
+    game.AddGarbage(2, 0);
+    REQUIRE(game.IsOver());
+    timer.Step();
+    REQUIRE(game.LastAction() == eAction::GameOver);
+  }
+}
+
 TEST_CASE("minimal end to end game ") {
   TestableTimer timer;
 
@@ -472,3 +637,36 @@ TEST_CASE("minimal end to end game ") {
 
   // std::cout << dump(game) << std::endl;
 }
+
+TEST_CASE("headless game runs on simulated time") {
+  VirtualTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TetriminosGenerator gen(std::random_device{}());
+  Tetris game(user_input, timer, score, gen, 1);
+  InputListener& input = game;
+  input.OnResume();
+
+  int events = 0;
+  while (!game.IsOver() && events < 10000) {
+    REQUIRE(timer.AdvanceToNextEvent());
+    events++;
+  }
+  REQUIRE(game.IsOver());
+  REQUIRE(timer.Now() == events * std::chrono::seconds{1});  // DummyScore drop period
+}
+
+TEST_CASE("headless engine plays with final collaborators") {
+  UserInput user_input;
+  VirtualTimer timer;
+  NintendoClassicScore score;
+  TetriminosGenerator gen(std::random_device{}());
+  HeadlessTetris game(user_input, timer, score, gen, 1);
+  STATIC_REQUIRE(std::is_same<HeadlessTetris::Score, NintendoClassicScore>::value);
+
+  InputListener& input = game;
+  input.OnResume();
+  REQUIRE(game.AdvanceFrames(1000000) < 1000000);
+  REQUIRE(game.IsOver());
+  REQUIRE(game.Scoring().Score() > 0);
+}
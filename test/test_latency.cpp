@@ -0,0 +1,102 @@
+#include <Tetris/LatencyProbe.h>
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+using namespace tetris;
+using namespace std::literals::chrono_literals;
+
+TEST_CASE("latency histogram buckets") {
+  SECTION("small values are exact") {
+    for (uint64_t v = 0; v < LatencyHistogram::kSubBuckets; v++) {
+      REQUIRE(LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketIndex(v)) == v);
+    }
+  }
+
+  SECTION("bucket upper bound is close to the recorded value") {
+    for (uint64_t v : {17ull, 100ull, 1234ull, 99999ull, 123456789ull, 1ull << 62}) {
+      auto upper = LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketIndex(v));
+      INFO("value: " << v << " upper: " << upper);
+      REQUIRE(upper >= v);
+      REQUIRE(upper - v <= v / LatencyHistogram::kSubBuckets);
+    }
+  }
+
+  SECTION("indexes are contiguous and fit in the histogram") {
+    REQUIRE(LatencyHistogram::BucketIndex(~0ull) < LatencyHistogram::kBuckets);
+    REQUIRE(LatencyHistogram::BucketIndex(16) == LatencyHistogram::BucketIndex(15) + 1);
+  }
+}
+
+TEST_CASE("latency histogram percentiles") {
+  LatencyHistogram histogram;
+  REQUIRE(histogram.Count() == 0);
+  REQUIRE(histogram.Percentile(0.5) == 0ns);
+
+  for (int i = 1; i <= 1000; i++) {
+    histogram.Record(std::chrono::microseconds{i});
+  }
+  REQUIRE(histogram.Count() == 1000);
+
+  auto near = [](std::chrono::nanoseconds value, std::chrono::nanoseconds expected) {
+    return value >= expected && value <= expected + expected / LatencyHistogram::kSubBuckets;
+  };
+  REQUIRE(near(histogram.Percentile(0.5), 500us));
+  REQUIRE(near(histogram.Percentile(0.99), 990us));
+  REQUIRE(near(histogram.Percentile(0.999), 999us));
+  REQUIRE(near(histogram.Max(), 1000us));
+
+  histogram.Reset();
+  REQUIRE(histogram.Count() == 0);
+}
+
+TEST_CASE("latency histogram can be recorded from several threads") {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram]() {
+      for (int i = 0; i < 10000; i++)
+        histogram.Record(std::chrono::nanoseconds{i});
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  REQUIRE(histogram.Count() == 40000);
+}
+
+TEST_CASE("latency tracer only records probes inside a sample") {
+  auto& tracer = LatencyTracer::Instance();
+  tracer.Reset();
+
+  tracer.Mark(eLatencyProbe::Fire);  // no key pending
+  REQUIRE(tracer.Histogram(eLatencyProbe::Fire).Count() == 0);
+
+  tracer.Begin();
+  tracer.Mark(eLatencyProbe::KeyRead);
+  tracer.Mark(eLatencyProbe::Fire);
+  tracer.Mark(eLatencyProbe::Engine);
+  tracer.End();
+
+  REQUIRE(tracer.Histogram(eLatencyProbe::KeyRead).Count() == 1);
+  REQUIRE(tracer.Histogram(eLatencyProbe::Fire).Count() == 1);
+  REQUIRE(tracer.Histogram(eLatencyProbe::Engine).Count() == 1);
+  REQUIRE(tracer.Histogram(eLatencyProbe::Render).Count() == 1);
+  REQUIRE(tracer.Histogram(eLatencyProbe::Render).Percentile(0.5) >=
+          tracer.Histogram(eLatencyProbe::KeyRead).Percentile(0.5));
+
+  tracer.Mark(eLatencyProbe::Render);  // timer driven redraw
+  REQUIRE(tracer.Histogram(eLatencyProbe::Render).Count() == 1);
+
+  tracer.Begin();  // unassigned key, nothing drawn
+  tracer.Mark(eLatencyProbe::KeyRead);
+  tracer.Cancel();
+  tracer.Mark(eLatencyProbe::Render);
+  REQUIRE(tracer.Histogram(eLatencyProbe::KeyRead).Count() == 2);
+  REQUIRE(tracer.Histogram(eLatencyProbe::Render).Count() == 1);
+
+  std::ostringstream out;
+  tracer.Dump(out);
+  REQUIRE(out.str().find("render") != std::string::npos);
+  tracer.Reset();
+}
@@ -0,0 +1,197 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <memory>
+
+#include <Tetris/LockDelay.h>
+#include <Tetris/Tetris.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+using namespace std::literals::chrono_literals;
+
+TEST_CASE("lock delay policies") {
+  STATIC_REQUIRE(LockDelay::Classic().IsImmediate());
+  STATIC_REQUIRE(LockDelay::Infinite(500ms).MaxResets() == LockDelay::kUnlimited);
+  STATIC_REQUIRE(LockDelay::MoveReset(500ms).MaxResets() == 15);
+  STATIC_REQUIRE(LockDelay::MoveReset(500ms, 3).Reset() == LockDelay::eReset::OnMove);
+  STATIC_REQUIRE(LockDelay::StepReset(500ms).Reset() == LockDelay::eReset::OnStep);
+  STATIC_REQUIRE(LockDelay::StepReset(500ms).Delay() == 500ms);
+}
+
+TEST_CASE("lock countdown") {
+  LockCountdown lock{LockDelay::MoveReset(500ms, 2)};
+  lock.OnSpawn(0);
+  REQUIRE(lock.OnMove() == false);  // not on the ground
+
+  REQUIRE(lock.OnFall(10) == false);
+  REQUIRE(lock.OnBlocked() == false);
+  REQUIRE(lock.IsRunning());
+
+  REQUIRE(lock.OnMove());
+  REQUIRE(lock.OnMove());
+  REQUIRE(lock.OnMove() == false);  // cap reached
+  REQUIRE(lock.Resets() == 2);
+
+  SECTION("expires") { REQUIRE(lock.OnBlocked()); }
+
+  SECTION("a lower row starts over") {
+    REQUIRE(lock.OnFall(11));
+    REQUIRE(lock.Resets() == 0);
+    REQUIRE(lock.OnBlocked() == false);
+  }
+
+  SECTION("landing again after a kick up keeps the resets done") {
+    REQUIRE(lock.OnFall(10));
+    REQUIRE(lock.OnBlocked() == false);
+    REQUIRE(lock.Resets() == 2);
+    REQUIRE(lock.OnMove() == false);
+  }
+}
+
+struct LockDelayFixture {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  std::unique_ptr<TetrisTestable> game;
+
+  explicit LockDelayFixture(const LockDelay& policy,
+                            Tetriminos::eType type = Tetriminos::eType::O) {
+    for (int i = 0; i < 3; i++)
+      gen.buf.push_back(Tetriminos{type});
+    game = std::make_unique<TetrisTestable>(user_input, timer, score, gen, 1);
+    game->SetLockDelay(policy);
+    game->OnResume();
+  }
+
+  //! fall until the lock delay starts
+  void Ground() {
+    while (game->LastAction() != eAction::LockDelay) {
+      REQUIRE(game->LastAction() != eAction::Land);
+      timer.Step();
+    }
+  }
+};
+
+TEST_CASE("classic lock delay lands on the first blocked step") {
+  LockDelayFixture f{LockDelay::Classic()};
+  while (f.game->LastAction() != eAction::Land)
+    f.timer.Step();
+  REQUIRE(f.game->IsLocking() == false);
+  REQUIRE(f.timer.start_call == 1);
+}
+
+TEST_CASE("move reset lock delay") {
+  LockDelayFixture f{LockDelay::MoveReset(500ms, 2)};
+  auto& game = *f.game;
+  f.Ground();
+
+  REQUIRE(game.IsLocking());
+  REQUIRE(f.timer.period == 500ms);
+  const int starts = f.timer.start_call;
+
+  SECTION("lands when the delay expires") {
+    f.timer.Step();
+    REQUIRE(game.LastAction() == eAction::Land);
+    REQUIRE(game.IsLocking() == false);
+    REQUIRE(f.timer.period == 1s);
+  }
+
+  SECTION("moves restart the delay up to the cap") {
+    game.OnLeft();
+    game.OnRight();
+    REQUIRE(f.timer.start_call == starts + 2);
+    game.OnLeft();
+    REQUIRE(f.timer.start_call == starts + 2);
+
+    f.timer.Step();
+    REQUIRE(game.LastAction() == eAction::Land);
+  }
+
+  SECTION("soft drop locks a grounded tetriminos") {
+    game.OnFastDown();
+    REQUIRE(game.LastAction() == eAction::Land);
+  }
+
+  SECTION("resume while locking runs the delay") {
+    game.OnPause();
+    game.OnResume();
+    REQUIRE(f.timer.period == 500ms);
+  }
+}
+
+TEST_CASE("sliding off a ledge goes back to gravity") {
+  LockDelayFixture f{LockDelay::MoveReset(500ms)};
+  auto& game = *f.game;
+  const int w = game.Width() / 2;
+  game.AddStaleBlocks({Pos{w, game.Height() - 1}, Pos{w + 1, game.Height() - 1}});
+  f.Ground();
+
+  game.OnLeft();
+  game.OnLeft();
+  f.timer.Step();
+  REQUIRE(game.LastAction() == eAction::Down);
+  REQUIRE(game.IsLocking() == false);
+  REQUIRE(f.timer.period == 1s);
+
+  f.Ground();
+  REQUIRE(game.Current().Position().y == game.Height() - 2);
+}
+
+TEST_CASE("a tetriminos rotated then sliding off a ledge gets its lock delay") {
+  LockDelayFixture f{LockDelay::StepReset(500ms), Tetriminos::eType::T};
+  auto& game = *f.game;
+  const int h = game.Height();
+  for (int x = 4; x < 8; x++)
+    game.AddStaleBlocks({Pos{x, h - 1}});
+  f.Ground();
+  const int bottom = h - 2;
+
+  // the kicks lift the origin, the blocks stay on the ledge
+  game.OnRotate();
+  game.OnRotate();
+  for (int i = 0; i < 3; i++)
+    game.OnLeft();
+  const auto blocks = game.Current().BlocksAbsolutePosition();
+  REQUIRE(std::all_of(blocks.begin(), blocks.end(), [](const Pos& p) { return p.x < 4; }));
+
+  f.timer.Step();  // falls off the ledge, a lower row
+  REQUIRE(game.LastAction() == eAction::Down);
+  REQUIRE(game.Current().Position().y + game.Current().BlocksBounds().bottom == bottom + 1);
+  f.timer.Step();
+  REQUIRE(game.LastAction() == eAction::LockDelay);
+  REQUIRE(f.timer.period == 500ms);
+  f.timer.Step();
+  REQUIRE(game.LastAction() == eAction::Land);
+}
+
+TEST_CASE("step reset lock delay ignores moves") {
+  LockDelayFixture f{LockDelay::StepReset(500ms)};
+  auto& game = *f.game;
+  f.Ground();
+  const int starts = f.timer.start_call;
+
+  game.OnLeft();
+  game.OnRotate();
+  REQUIRE(f.timer.start_call == starts);
+
+  f.timer.Step();
+  REQUIRE(game.LastAction() == eAction::Land);
+}
+
+TEST_CASE("infinite lock delay") {
+  LockDelayFixture f{LockDelay::Infinite(500ms)};
+  auto& game = *f.game;
+  f.Ground();
+  const int starts = f.timer.start_call;
+
+  for (int i = 0; i < 100; i++)
+    i % 2 ? game.OnLeft() : game.OnRight();
+  REQUIRE(f.timer.start_call == starts + 100);
+  REQUIRE(game.IsLocking());
+
+  game.OnHardDrop();
+  REQUIRE(game.LastAction() == eAction::Land);
+  REQUIRE(f.timer.period == 1s);
+}
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/Observation.h>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+namespace {
+
+std::vector<uint8_t> Pack(const std::vector<uint8_t>& bytes) {
+  std::vector<uint8_t> bits((bytes.size() + 7) / 8);
+  for (size_t i = 0; i < bytes.size(); i++)
+    bits[i / 8] |= bytes[i] << (i % 8);
+  return bits;
+}
+
+}  // namespace
+
+TEST_CASE("observation of the engine") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::T},
+                                  Tetriminos{t::S}};
+  TetrisTestable game(user_input, timer, score, gen, 3);
+  game.AddStaleBlocks({Pos{0, 24}, Pos{9, 24}, Pos{3, 10}});
+
+  const auto layout = LayoutOf(game, 2);
+  REQUIRE(layout.Values() == 2 * 10 * 25 + 7 * 3);
+  REQUIRE(layout.Size(eObservationFormat::Bits) == (layout.Values() + 7) / 8);
+
+  std::vector<uint8_t> bytes(layout.Size(eObservationFormat::Bytes), 0xFF);
+  WriteObservation(game, 2, eObservationFormat::Bytes, bytes.data());
+
+  const auto cell = [&](int plane, Pos pos) { return bytes[plane * 250 + pos.y * 10 + pos.x]; };
+  SECTION("stale blocks") {
+    REQUIRE(std::count(bytes.begin(), bytes.begin() + 250, 1) == 3);
+    REQUIRE(cell(0, Pos{0, 24}) == 1);
+    REQUIRE(cell(0, Pos{9, 24}) == 1);
+    REQUIRE(cell(0, Pos{3, 10}) == 1);
+  }
+  SECTION("current tetriminos") {
+    REQUIRE(std::count(bytes.begin() + 250, bytes.begin() + 500, 1) == 4);
+    for (const Pos& pos : game.Current().BlocksAbsolutePosition())
+      REQUIRE(cell(1, pos) == 1);
+  }
+  SECTION("one hot types") {
+    const std::vector<uint8_t> types(bytes.begin() + 500, bytes.end());
+    REQUIRE(types == std::vector<uint8_t>{0, 1, 0, 0, 0, 0, 0,    // O
+                                          1, 0, 0, 0, 0, 0, 0,    // I
+                                          0, 0, 1, 0, 0, 0, 0});  // T
+  }
+  SECTION("bit packed") {
+    std::vector<uint8_t> bits(layout.Size(eObservationFormat::Bits));
+    WriteObservation(game, 2, eObservationFormat::Bits, bits.data());
+    REQUIRE(bits == Pack(bytes));
+  }
+}
+
+TEST_CASE("observation of a batch game") {
+  TetrisBatch batch(3, 9, BoardSize{10, 20}, 2);
+  for (int i = 0; i < 2; i++)
+    batch.Step({eBatchAction::None, eBatchAction::HardDrop, eBatchAction::Left});
+
+  const auto layout = LayoutOf(batch);
+  std::vector<uint8_t> bytes(layout.Size(eObservationFormat::Bytes));
+  WriteObservation(batch, 1, eObservationFormat::Bytes, bytes.data());
+
+  REQUIRE(std::count(bytes.begin(), bytes.begin() + 200, 1) == 8);
+  REQUIRE(bytes[400 + static_cast<int>(batch.Current(1).Type())] == 1);
+  REQUIRE(bytes[407 + static_cast<int>(batch.Next(1))] == 1);
+  REQUIRE(bytes[414 + static_cast<int>(batch.Next(1, 1))] == 1);
+}
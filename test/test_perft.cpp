@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/Perft.h>
+#include <map>
+
+using namespace tetris;
+
+TEST_CASE("placements of each tetriminos on an empty playfield") {
+  using t = Tetriminos::eType;
+  // columns times distinct orientations
+  const std::map<t, size_t> expected{{t::I, 7 + 10}, {t::O, 9},      {t::T, 8 + 8 + 9 + 9},
+                                     {t::L, 34},     {t::J, 34},     {t::S, 8 + 9},
+                                     {t::Z, 8 + 9}};
+  std::map<t, size_t> found;
+  for (uint32_t seed = 0; seed < 30; seed++) {
+    Perft perft(seed);
+    found[perft.Game().Current().Type()] = perft.Placements().size();
+  }
+  REQUIRE(found == expected);
+}
+
+TEST_CASE("perft golden counts") {
+  SECTION("empty playfield") {
+    Perft perft(1);
+    REQUIRE(perft.Count(1) == 17);
+    REQUIRE(perft.Count(2) == 17 * 9);
+    REQUIRE(perft.Count(3) == 2702);
+    REQUIRE(perft.Moves() > 0);
+  }
+
+  SECTION("counting leaves the game as it was") {
+    Perft perft(2);
+    const auto current = perft.Game().Current();
+    const auto history = perft.Game().History().size();
+    REQUIRE(perft.Count(2) == 1182);
+    REQUIRE(perft.Game().Current().Position() == current.Position());
+    REQUIRE(perft.Game().Playfield().IsEmpty());
+    REQUIRE(perft.Game().History().size() == history);
+    REQUIRE(perft.Count(2) == 1182);
+    REQUIRE(perft.Count(1) == 34);
+    REQUIRE(perft.Placements().size() == 34);
+    REQUIRE(perft.Game().History().size() == history);
+  }
+
+  SECTION("garbage rows") {
+    Perft perft(3);
+    perft.Game().AddGarbage(6, 4);
+    REQUIRE(perft.Count(1) == 17);
+    REQUIRE(perft.Count(2) == 578);
+  }
+
+  SECTION("placed tetriminos") {
+    Perft perft(1);
+    const auto placements = perft.Placements();
+    perft.Place(placements.front());
+    REQUIRE(perft.Game().Playfield().IsEmpty() == false);
+    REQUIRE(perft.Count(1) == 9);
+  }
+}
+
+TEST_CASE("perft ends sequences on game over") {
+  Perft perft(5);  // O
+  perft.Game().AddGarbage(23, 0);
+  REQUIRE(perft.Count(1) == 9);  // on the two rows left
+  REQUIRE(perft.Count(2) == 59);
+
+  const auto placements = perft.Placements();
+  REQUIRE(placements.front().Position() == perft.Game().Current().Position());
+  perft.Place(placements.front());  // where the next one spawns
+  REQUIRE(perft.Game().IsOver());
+  REQUIRE(perft.Count(1) == 0);
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/ImageWriter.h>
+#include <Tetris/Rasterizer.h>
+#include <sstream>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+TEST_CASE("offscreen rasterizer") {
+  TestableTimer timer;
+  UserInput user_input;
+  DummyScore score;
+  TestableGenerator gen;
+  using t = Tetriminos::eType;
+  using c = Tetriminos::eColor;
+  gen.buf = std::list<Tetriminos>{Tetriminos{t::O}, Tetriminos{t::I}, Tetriminos{t::T}};
+  TetrisTestable game(user_input, timer, score, gen, 1);
+  game.AddStaleBlocks({Pos{0, 24}, Pos{9, 24}});  // blue
+
+  Rasterizer rasterizer(game.Playfield().Size());
+  REQUIRE(rasterizer.Width() == (10 + Rasterizer::kPanelCells) * 8);
+  REQUIRE(rasterizer.Height() == 25 * 8);
+  const auto& pixels = rasterizer.Render(game);
+  REQUIRE(pixels.size() == static_cast<size_t>(rasterizer.Width()) * rasterizer.Height() * 4);
+  const auto* data = pixels.data();
+
+  //! color of the pixel at (x,y) in cell (cx,cy)
+  const auto pixel = [&rasterizer](int cx, int cy, int x = 3, int y = 3) {
+    const auto i = ((cy * 8 + y) * rasterizer.Width() + cx * 8 + x) * 4;
+    const auto& p = rasterizer.Pixels();
+    return Rasterizer::Rgba{p[i], p[i + 1], p[i + 2], p[i + 3]};
+  };
+
+  REQUIRE(pixel(0, 24) == Rasterizer::ColorOf(c::Blue));
+  REQUIRE(pixel(9, 24, 0, 0) == Rasterizer::ColorOf(c::Blue));
+  REQUIRE(pixel(0, 24, 7, 3) == Rasterizer::kBackground);  // grid line
+  REQUIRE(pixel(1, 24) == Rasterizer::kBackground);
+  REQUIRE(pixel(5, 0) == Rasterizer::ColorOf(c::Yellow));  // current O
+  REQUIRE(pixel(6, 1) == Rasterizer::ColorOf(c::Yellow));
+  const auto ghost = pixel(5, 24);
+  REQUIRE(ghost != Rasterizer::kBackground);
+  REQUIRE(ghost != Rasterizer::ColorOf(c::Yellow));
+  REQUIRE(pixel(13, 2) == Rasterizer::ColorOf(c::Cyan));  // preview I
+
+  SECTION("a spectator state renders the same image") {
+    Rasterizer spectator(game.Playfield().Size());
+    REQUIRE(spectator.Render(SpectatorState::Of(game, 1)) == pixels);
+  }
+
+  SECTION("the image buffer is reused") {
+    InputListener& input = game;
+    input.OnResume();
+    input.OnHardDrop();
+    rasterizer.Render(game);
+    REQUIRE(rasterizer.Pixels().data() == data);
+    REQUIRE(pixel(5, 23) == Rasterizer::ColorOf(c::Yellow));
+    REQUIRE(pixel(5, 0) == Rasterizer::ColorOf(c::Cyan));  // I spawned
+  }
+}
+
+TEST_CASE("image sequence writer") {
+  Rasterizer rasterizer(BoardSize{4, 6}, 2, 2);
+  REQUIRE(rasterizer.Width() == 20);
+  REQUIRE(rasterizer.Height() == 14);  // the preview is taller than the playfield
+  std::ostringstream out;
+
+  SECTION("PPM") {
+    ImageSequenceWriter writer(out, ImageSequenceWriter::eFormat::Ppm);
+    writer.Write(rasterizer);
+    writer.Write(rasterizer);
+    const std::string header = "P6\n20 14\n255\n";
+    const size_t size = header.size() + 20 * 14 * 3;
+    REQUIRE(out.str().size() == 2 * size);
+    REQUIRE(out.str().substr(0, header.size()) == header);
+    REQUIRE(out.str().substr(size, header.size()) == header);
+    const auto bg = Rasterizer::kBackground;
+    const std::string rgb{char(bg[0]), char(bg[1]), char(bg[2])};
+    REQUIRE(out.str().substr(header.size(), 3) == rgb);
+    REQUIRE(writer.Frames() == 2);
+  }
+
+  SECTION("PNG") {
+    ImageSequenceWriter writer(out, ImageSequenceWriter::eFormat::Png);
+    writer.Write(rasterizer);
+    const std::string png = out.str();
+    REQUIRE(png.substr(0, 8) == "\x89PNG\r\n\x1a\n");
+    REQUIRE(png.substr(8, 16) == std::string("\0\0\0\x0dIHDR\0\0\0\x14\0\0\0\x0e", 16));
+    REQUIRE(png.substr(24, 5) == std::string("\x08\x06\0\0\0", 5));
+    // signature, IHDR, IDAT of the zlib header, a stored block and adler32, IEND
+    const size_t raw = (20 * 4 + 1) * 14;
+    REQUIRE(png.size() == 8 + 25 + 12 + 2 + 5 + raw + 4 + 12);
+    REQUIRE(png.substr(png.size() - 12) == std::string("\0\0\0\0IEND\xae\x42\x60\x82", 12));
+  }
+
+  SECTION("a failed stream throws") {
+    ImageSequenceWriter writer(out, ImageSequenceWriter::eFormat::Png);
+    out.setstate(std::ios::badbit);
+    REQUIRE_THROWS_AS(writer.Write(rasterizer), std::runtime_error);
+    REQUIRE(writer.Frames() == 0);
+  }
+}
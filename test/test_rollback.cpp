@@ -0,0 +1,200 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/RollbackSession.h>
+#include <Tetris/SpectatorStream.h>
+#include <deque>
+#include <random>
+
+using namespace tetris;
+
+namespace {
+
+//! keys of @param player at @param frame, the same whoever asks
+FrameInput ScriptedInput(int player, int64_t frame) {
+  uint32_t h = static_cast<uint32_t>(frame * 2654435761u) ^ static_cast<uint32_t>(player * 40503);
+  h ^= h >> 15;
+  h *= 2246822519u;
+  h ^= h >> 13;
+  if (h % 6)
+    return 0;  // most frames have no key
+  constexpr eInputKey keys[] = {eInputKey::Left,   eInputKey::Right,    eInputKey::Rotate,
+                                eInputKey::Rotate, eInputKey::FastDown, eInputKey::HardDrop};
+  return InputOf(keys[(h >> 8) % 6]);
+}
+
+struct Packet {
+  int64_t arrival;  //!< tick
+  int player;
+  int64_t first;  //!< frame of inputs[0]
+  std::vector<FrameInput> inputs;
+};
+
+//! unreliable link between two peers: latency and loss in ticks of 1 frame
+class Loopback {
+ public:
+  Loopback(int min_latency_p, int max_latency_p, double loss_p)
+      : min_latency(min_latency_p), max_latency(max_latency_p), loss(loss_p) {}
+
+  //! the local inputs still in the rollback window, lost ones are sent again
+  void Send(const RollbackSession& from, int player, int64_t tick, std::deque<Packet>& to) {
+    Packet packet{tick + std::uniform_int_distribution<int>(min_latency, max_latency)(rng), player,
+                  std::max<int64_t>(0, from.Frame() - 2 * from.MaxRollback()), {}};
+    for (int64_t f = packet.first; f < from.Frame(); f++)
+      packet.inputs.push_back(from.Input(player, f));
+    if (std::bernoulli_distribution(loss)(rng))
+      return;
+    to.push_back(packet);
+  }
+
+  static void Deliver(int64_t tick, std::deque<Packet>& packets, RollbackSession& to) {
+    for (auto it = packets.begin(); it != packets.end();) {
+      if (it->arrival > tick) {
+        ++it;
+        continue;
+      }
+      for (size_t i = 0; i < it->inputs.size(); i++)
+        to.AddRemoteInput(it->player, it->first + static_cast<int64_t>(i), it->inputs[i]);
+      it = packets.erase(it);
+    }
+  }
+
+ private:
+  int min_latency;
+  int max_latency;
+  double loss;
+  std::mt19937 rng{3};
+};
+
+void RequireSameGames(const RollbackSession& a, const RollbackSession& b) {
+  for (int player = 0; player < a.Players(); player++)
+    REQUIRE(SpectatorState::Of(a.Game(player), 3) == SpectatorState::Of(b.Game(player), 3));
+}
+
+}  // namespace
+
+TEST_CASE("engine state saved and loaded") {
+  UserInput user_input;
+  VirtualTimer timer;
+  NintendoClassicScore score;
+  TetriminosGenerator gen(11);
+  HeadlessTetris game(user_input, timer, score, gen, 3);
+  InputListener& input = game;
+  input.OnResume();
+
+  HeadlessTetris::State state;
+  game.SaveState(state);
+  const auto saved_score = score;
+  const auto saved_gen = gen;
+  const auto before = SpectatorState::Of(game, 3);
+
+  for (int i = 0; i < 5; i++) {
+    input.OnLeft();
+    input.OnHardDrop();
+  }
+  game.AdvanceFrames(30);
+  REQUIRE(SpectatorState::Of(game, 3) != before);
+
+  game.LoadState(state);
+  score = saved_score;
+  gen = saved_gen;
+  REQUIRE(SpectatorState::Of(game, 3) == before);
+  REQUIRE(game.History().size() == state.nb_actions);
+  REQUIRE(game.Frame() == 0);
+}
+
+TEST_CASE("rollback session") {
+  RollbackSession::Config config;
+  config.seed = 5;
+  config.max_rollback = 4;
+
+  SECTION("no rollback when inputs are in time") {
+    RollbackSession session(config);
+    for (int64_t f = 0; f < 100; f++) {
+      session.AddRemoteInput(1, f, ScriptedInput(1, f));
+      REQUIRE(session.AdvanceFrame(ScriptedInput(0, f)));
+    }
+    REQUIRE(session.ConfirmedFrame() == 100);
+    REQUIRE(session.Stats().frames == 100);
+    REQUIRE(session.Stats().rollbacks == 0);
+  }
+
+  SECTION("late input is resimulated") {
+    RollbackSession reference(config), session(config);
+    for (int64_t f = 0; f < 3; f++) {
+      reference.AddRemoteInput(1, f, f == 1 ? InputOf(eInputKey::Right) : 0);
+      reference.AdvanceFrame(0);
+      REQUIRE(session.AdvanceFrame(0));
+    }
+    REQUIRE(session.Game(1).Current().Position().x == reference.Game(1).Current().Position().x - 1);
+
+    session.AddRemoteInput(1, 1, InputOf(eInputKey::Right));
+    session.AddRemoteInput(1, 0, 0);
+    session.Rollback();
+    RequireSameGames(session, reference);
+    REQUIRE(session.Stats().rollbacks == 1);
+    REQUIRE(session.Stats().resimulated_frames == 2);
+    REQUIRE(session.Stats().max_depth == 2);
+    REQUIRE(session.ConfirmedFrame() == 2);
+  }
+
+  SECTION("prediction stops at max rollback") {
+    RollbackSession session(config);
+    for (int f = 0; f < config.max_rollback; f++)
+      REQUIRE(session.AdvanceFrame(0));
+    REQUIRE(session.AdvanceFrame(0) == false);
+    REQUIRE(session.Stats().stalls == 1);
+    session.AddRemoteInput(1, 0, 0);
+    REQUIRE(session.AdvanceFrame(0));
+    REQUIRE_THROWS(session.AddRemoteInput(1, session.Frame() + config.max_rollback, 0));
+    REQUIRE_THROWS(session.AddRemoteInput(0, 1, 0));
+  }
+}
+
+TEST_CASE("rollback peers converge over a lossy link") {
+  const double loss = GENERATE(0.0, 0.2, 0.5);
+  RollbackSession::Config config;
+  config.seed = 9;
+  config.max_rollback = 8;
+  RollbackSession a(config);
+  config.local_player = 1;
+  RollbackSession b(config);
+
+  Loopback link(2, 6, loss);
+  std::deque<Packet> to_a, to_b;
+  constexpr int64_t kFrames = 600;
+  int64_t tick = 0;
+  for (; tick < 100 * kFrames && (a.ConfirmedFrame() < kFrames || b.ConfirmedFrame() < kFrames);
+       tick++) {
+    Loopback::Deliver(tick, to_a, a);
+    Loopback::Deliver(tick, to_b, b);
+    if (a.Frame() < kFrames)
+      a.AdvanceFrame(ScriptedInput(0, a.Frame()));
+    if (b.Frame() < kFrames)
+      b.AdvanceFrame(ScriptedInput(1, b.Frame()));
+    link.Send(a, 0, tick, to_b);
+    link.Send(b, 1, tick, to_a);
+  }
+  a.Rollback();
+  b.Rollback();
+  REQUIRE(a.ConfirmedFrame() == kFrames);
+  REQUIRE(b.ConfirmedFrame() == kFrames);
+
+  config.local_player = 0;
+  RollbackSession reference(config);
+  for (int64_t f = 0; f < kFrames; f++) {
+    reference.AddRemoteInput(1, f, ScriptedInput(1, f));
+    reference.AdvanceFrame(ScriptedInput(0, f));
+  }
+  RequireSameGames(a, reference);
+  RequireSameGames(b, reference);
+  REQUIRE(reference.Game(0).History() != reference.Game(1).History());
+
+  for (const auto* peer : {&a, &b}) {
+    const auto& stats = peer->Stats();
+    REQUIRE(stats.frames == kFrames);
+    REQUIRE(stats.rollbacks > 0);
+    REQUIRE(stats.max_depth <= config.max_rollback);
+    REQUIRE(stats.resimulation.calls == stats.rollbacks);
+    REQUIRE(stats.resimulation.max >= stats.resimulation.min);
+  }
+}
@@ -15,6 +15,7 @@ struct MockScore : tetris::IScore {
   int comp_line_arg{};
   int perfect_clear{};
   int soft_drop{};
+  int hard_drop_cells{};
   bool change_level{false};
   void OnNewTetriminos() override { new_tetri++; };
   bool OnCompletedLine(int nb_line) override {
@@ -24,6 +25,7 @@ struct MockScore : tetris::IScore {
   };
   void OnPerfectClear() override { perfect_clear++; };
   void OnSoftDrop() override { soft_drop++; };
+  void OnHardDrop(int nb_cells) override { hard_drop_cells += nb_cells; };
   int Score() const override { return 0; };
   int Level() const override { return 1; };
   int CompletedLines() const override { return 2; };
@@ -116,6 +118,27 @@ TEST_CASE("soft drop call") {
   }
 }
 
+TEST_CASE("hard drop call") {
+  TestableTimer timer;
+  UserInput user_input;
+  MockScore score;
+  TestableGenerator gen;
+  gen.buf = std::list<Tetriminos>{Tetriminos{"I"}, Tetriminos{"I"}, Tetriminos{"I"}};
+
+  TetrisTestable game(user_input, timer, score, gen, 1);
+
+  SECTION("dont move on pause") {
+    game.OnHardDrop();
+    REQUIRE(score.hard_drop_cells == 0);
+  }
+
+  SECTION("credit every skipped row") {
+    game.OnResume();
+    game.OnHardDrop();
+    REQUIRE(score.hard_drop_cells == game.Height() - 1);
+  }
+}
+
 TEST_CASE("restart timer on level change") {
   TestableTimer timer;
   UserInput user_input;
@@ -153,6 +176,10 @@ TEST_CASE(" Nintendo gaming scoring") {
     score.OnSoftDrop();
     REQUIRE(score.Score() == 1);
   }
+  SECTION(" score increment 2 per cell on hard drop") {
+    score.OnHardDrop(10);
+    REQUIRE(score.Score() == 20);
+  }
   SECTION(" score increment 1 on new tetriminos") {
     score.OnNewTetriminos();
     REQUIRE(score.Score() == 1);
@@ -179,4 +206,41 @@ TEST_CASE(" Nintendo gaming scoring") {
     score.OnPerfectClear();
     REQUIRE(score.Score() == 0);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("gravity curves are computed at compile time") {
+  using namespace std::literals::chrono_literals;
+  STATIC_REQUIRE(kNintendoClassicGravity.Levels() == 19);
+  STATIC_REQUIRE(kNintendoClassicGravity.DropPeriod(1) == 999ms);
+  STATIC_REQUIRE(kNintendoClassicGravity.DropPeriod(3) == 617ms);
+  STATIC_REQUIRE(kNintendoClassicGravity.FramesPerCell(1) == 60);
+  STATIC_REQUIRE(kNintendoClassicGravity.FramesPerCell(19) == 1);
+  STATIC_REQUIRE(kNintendoClassicGravity.DropPeriod(42) == kNintendoClassicGravity.DropPeriod(19));
+  STATIC_REQUIRE(kNintendoClassicGravity.DropPeriod(0) == kNintendoClassicGravity.DropPeriod(1));
+  STATIC_REQUIRE(kNintendoClassicGravity.DropPeriod(19) == 1ms);  // 20G, still runs on a timer
+}
+
+namespace {
+constexpr GravityCurve kTestCurve{std::array<double, 3>{0.5, 1, 2}};
+
+struct CurvedScore : CurveScore<kTestCurve> {
+  int level{1};
+  void OnNewTetriminos() override {}
+  bool OnCompletedLine(int nb_line) override { return false; }
+  void OnPerfectClear() override {}
+  void OnSoftDrop() override {}
+  int Score() const override { return 0; }
+  int Level() const override { return level; }
+  int CompletedLines() const override { return 0; }
+};
+}  // namespace
+
+TEST_CASE("custom score can declare its gravity curve") {
+  using namespace std::literals::chrono_literals;
+  CurvedScore score;
+  REQUIRE(score.DropPeriod() == 33ms);
+  REQUIRE(score.GravityPerFrame() == Gravity::FromFramesPerCell(2));
+  score.level = 3;
+  REQUIRE(score.DropPeriod() == 8ms);
+  REQUIRE(score.DropPeriod(2) == 16ms);
+  REQUIRE(score.GravityPerFrame().per_frame == 2 * Gravity::kCell);
+}
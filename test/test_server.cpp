@@ -0,0 +1,224 @@
+#include <catch2/catch.hpp>
+
+#include <Server/MatchServer.h>
+#include <Server/Room.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <bitset>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+using namespace tetris;
+using namespace std::literals::chrono_literals;
+
+namespace {
+
+//! loopback client, reads run the server while waiting
+class Bot {
+ public:
+  explicit Bot(const std::string& unix_path) : fd(socket(AF_UNIX, SOCK_STREAM, 0)) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, unix_path.c_str());
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  }
+  explicit Bot(uint16_t port) : fd(socket(AF_INET, SOCK_STREAM, 0)) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  }
+  ~Bot() { close(fd); }
+
+  void Send(const std::string& line) {
+    const std::string data = line + '\n';
+    REQUIRE(send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size()));
+  }
+
+  //!@return next line from the server, empty after @param timeout
+  std::string Read(MatchServer& server, std::chrono::milliseconds timeout = 2s) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+      if (const auto end = in.find('\n'); end != std::string::npos) {
+        std::string line = in.substr(0, end);
+        in.erase(0, end + 1);
+        return line;
+      }
+      server.Poll(1ms);
+      char buffer[4096];
+      const ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+      if (n > 0)
+        in.append(buffer, static_cast<size_t>(n));
+    }
+    return {};
+  }
+
+ private:
+  int fd;
+  std::string in;
+};
+
+}  // namespace
+
+TEST_CASE("garbage sent for cleared lines") {
+  REQUIRE(GarbageOf(0) == 0);
+  REQUIRE(GarbageOf(1) == 0);
+  REQUIRE(GarbageOf(2) == 1);
+  REQUIRE(GarbageOf(3) == 2);
+  REQUIRE(GarbageOf(4) == 4);
+}
+
+TEST_CASE("versus room") {
+  TimerWheel wheel;
+  Room room(wheel, Room::Config{}, 7);
+
+  room.Join(10);
+  REQUIRE(room.IsStarted() == false);
+  REQUIRE(room.Game(10).IsPause());
+
+  room.Join(20);
+  REQUIRE(room.IsStarted());
+  REQUIRE_THROWS(room.Join(30));
+  REQUIRE(room.Game(10).IsPause() == false);
+  REQUIRE(room.Game(10).Current().Type() == room.Game(20).Current().Type());
+
+  SECTION("games fall with the shared wheel") {
+    wheel.AdvanceTo(2s);
+    REQUIRE(room.Game(10).Current().Position().y > 0);
+    REQUIRE(room.Game(20).Current().Position().y == room.Game(10).Current().Position().y);
+  }
+
+  SECTION("garbage is inserted when the opponent's tetriminos lands") {
+    room.Send(10, 4);
+    const auto events = room.Update();
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].type == RoomEvent::eType::Garbage);
+    REQUIRE(events[0].client == 20);
+    REQUIRE(events[0].rows == 4);
+    REQUIRE(room.PendingGarbage(20) == 4);
+
+    room.Press(20, eInputKey::HardDrop);
+    room.Update();
+    REQUIRE(room.PendingGarbage(20) == 0);
+    const auto& board = room.Game(20).Playfield();
+    for (int y = board.Height() - 4; y < board.Height(); y++)
+      REQUIRE(std::bitset<64>(board.RowMask(y)).count() == board.Width() - 1);
+    REQUIRE(room.Game(10).Playfield().IsEmpty() == true);
+  }
+
+  SECTION("last player standing wins") {
+    room.Leave(20);
+    const auto events = room.Update();
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].type == RoomEvent::eType::Over);
+    REQUIRE(events[0].client == 20);
+    REQUIRE(events[1].type == RoomEvent::eType::Win);
+    REQUIRE(events[1].client == 10);
+    REQUIRE(room.IsFinished());
+    REQUIRE(room.Update().empty());
+  }
+}
+
+TEST_CASE("garbage is sent for each clear between room updates") {
+  // a seed dealing 4 O, on a 4 columns playfield every second O clears 2 lines
+  const auto deals_o = [](uint32_t seed) {
+    TetriminosGenerator gen(static_cast<int>(seed));
+    for (int i = 0; i < 4; i++) {
+      if (gen.Create().Type() != Tetriminos::eType::O)
+        return false;
+    }
+    return true;
+  };
+  uint32_t seed = 0;
+  while (!deals_o(seed))
+    seed++;
+
+  TimerWheel wheel;
+  Room room(wheel, Room::Config{2, BoardSize{4, 10}}, seed);
+  room.Join(10);
+  room.Join(20);
+  for (int i = 0; i < 4; i++) {
+    if (i % 2) {
+      room.Press(20, eInputKey::Left);
+      room.Press(20, eInputKey::Left);
+    }
+    room.Press(20, eInputKey::HardDrop);
+  }
+  REQUIRE(room.Game(20).Scoring().CompletedLines() == 4);
+  REQUIRE(room.Game(20).Playfield().IsEmpty());
+
+  const auto events = room.Update();
+  REQUIRE(events.size() == 1);
+  REQUIRE(events[0].client == 10);
+  REQUIRE(events[0].rows == 2);  // two doubles, not a tetris
+  REQUIRE(room.PendingGarbage(10) == 2);
+}
+
+TEST_CASE("a waiting player leaving frees its seat") {
+  TimerWheel wheel;
+  Room room(wheel, Room::Config{}, 7);
+  room.Join(10);
+  room.Leave(10);
+  REQUIRE(room.Size() == 0);
+  REQUIRE(room.IsFinished());
+}
+
+TEST_CASE("match server plays versus over unix socket") {
+  MatchServer::Config config;
+  config.unix_path = "/tmp/tetris_test_server_" + std::to_string(getpid()) + ".sock";
+  config.seed = 42;
+  MatchServer server(config);
+
+  Bot a(config.unix_path), b(config.unix_path);
+  a.Send("JOIN arena");
+  REQUIRE(a.Read(server) == "WAIT");
+  b.Send("JOIN arena");
+  REQUIRE(a.Read(server) == "START 42");
+  REQUIRE(b.Read(server) == "START 42");
+  REQUIRE(server.RoomCount() == 1);
+
+  // a stacks its tetriminos in the middle until it tops out
+  std::string line;
+  for (int i = 0; i < 100 && line != "OVER"; i++) {
+    a.Send("DROP");
+    line = a.Read(server, 20ms);
+  }
+  REQUIRE(line == "OVER");
+  REQUIRE(b.Read(server) == "WIN");
+  REQUIRE(server.RoomCount() == 0);
+  REQUIRE(server.ClientCount() == 2);
+}
+
+TEST_CASE("match server over tcp") {
+  MatchServer::Config config;
+  config.room.capacity = 1;
+  MatchServer server(config);
+  REQUIRE(server.Port() != 0);
+
+  Bot bot(server.Port());
+  bot.Send("STATE");
+  REQUIRE(bot.Read(server) == "ERROR not in a room");
+  bot.Send("JUMP");
+  REQUIRE(bot.Read(server) == "ERROR unknown command JUMP");
+
+  bot.Send("JOIN solo");
+  REQUIRE(bot.Read(server) == "START 0");
+  bot.Send("STATE");
+  std::istringstream state(bot.Read(server));
+  std::vector<std::string> words{std::istream_iterator<std::string>(state), {}};
+  REQUIRE(words.size() == 7 + 25);
+  REQUIRE(words[0] == "STATE");
+  REQUIRE(words[1] == "1");  // new tetriminos
+  REQUIRE(words.back() == "0");  // empty bottom row
+
+  bot.Send("QUIT");
+  for (int i = 0; i < 100 && server.ClientCount(); i++)
+    server.Poll(1ms);
+  REQUIRE(server.ClientCount() == 0);
+  REQUIRE(server.RoomCount() == 0);
+}
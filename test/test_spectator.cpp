@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/HeadlessTetris.h>
+#include <Tetris/SpectatorStream.h>
+#include <algorithm>
+
+#include "Testables.h"
+
+using namespace tetris;
+
+namespace {
+
+//! headless game played by a pseudo random player, streamed to a spectator
+struct Spectated {
+  explicit Spectated(int seed, int preview = 1, int keyframe_interval = 600)
+      : gen(seed), game(user_input, timer, score, gen, 3), encoder(preview, keyframe_interval) {
+    static_cast<InputListener&>(game).OnResume();
+  }
+
+  //! one input or timer event, @return bytes sent to the spectator
+  size_t Step() {
+    InputListener& input = game;
+    rng = rng * 1664525u + 1013904223u;
+    switch (rng >> 29) {
+      case 0:
+        input.OnLeft();
+        break;
+      case 1:
+        input.OnRight();
+        break;
+      case 2:
+        input.OnRotate();
+        break;
+      case 3:
+        input.OnHardDrop();
+        break;
+      case 4:
+        input.OnFastDown();
+        break;
+      default:
+        timer.AdvanceToNextEvent();
+    }
+    return Stream();
+  }
+
+  size_t Stream() {
+    bytes.clear();
+    encoder.Encode(game, bytes);
+    decoder.Decode(bytes);
+    return bytes.size();
+  }
+
+  UserInput user_input;
+  VirtualTimer timer;
+  NintendoClassicScore score;
+  TetriminosGenerator gen;
+  HeadlessTetris game;
+  DeltaEncoder encoder;
+  DeltaDecoder decoder;
+  std::vector<uint8_t> bytes;
+  uint32_t rng{1};
+};
+
+}  // namespace
+
+TEST_CASE("spectator follows the game") {
+  const int preview = GENERATE(0, 1, 3);
+  Spectated spectated(7, preview);
+
+  REQUIRE(spectated.decoder.IsSynchronized() == false);
+  spectated.Stream();
+  REQUIRE(spectated.decoder.IsSynchronized());
+  REQUIRE(spectated.encoder.Keyframes() == 1);
+
+  int locks = 0;
+  for (int i = 0; i < 5000 && !spectated.game.IsOver(); i++) {
+    const auto& history = spectated.game.History();
+    const auto seen = history.size();
+    spectated.Step();
+    locks += static_cast<int>(std::count(history.begin() + seen, history.end(), eAction::Land));
+    REQUIRE(spectated.decoder.State() == SpectatorState::Of(spectated.game, preview));
+  }
+  REQUIRE(locks > 10);
+  // locks and line clears are replayed, keyframes are the exception
+  REQUIRE(spectated.encoder.Keyframes() < 1 + locks / 4);
+}
+
+TEST_CASE("spectator stream messages") {
+  Spectated spectated(3);
+  const size_t keyframe = spectated.Stream();
+  REQUIRE(keyframe > 10 * 25 / 8);
+
+  REQUIRE(spectated.Stream() == 0);  // nothing happened
+
+  InputListener& input = spectated.game;
+  input.OnLeft();
+  REQUIRE(spectated.Stream() == 3);
+
+  input.OnHardDrop();
+  const size_t lock = spectated.Stream();
+  REQUIRE(lock < 10);
+  REQUIRE(spectated.encoder.Keyframes() == 1);
+  REQUIRE(spectated.decoder.State() == SpectatorState::Of(spectated.game, 1));
+
+  SECTION("garbage is sent as a keyframe") {
+    spectated.game.AddGarbage(2, 4);
+    REQUIRE(spectated.Stream() > keyframe);
+    REQUIRE(spectated.encoder.Keyframes() == 2);
+    REQUIRE(spectated.decoder.State() == SpectatorState::Of(spectated.game, 1));
+  }
+
+  SECTION("periodic keyframes") {
+    DeltaEncoder encoder(1, 2);
+    std::vector<uint8_t> bytes;
+    for (int i = 0; i < 6; i++)
+      encoder.Encode(spectated.game, bytes);
+    REQUIRE(encoder.Keyframes() == 2);
+  }
+
+  SECTION("a spectator joining asks for a keyframe") {
+    DeltaDecoder late;
+    spectated.encoder.RequestKeyframe();
+    input.OnRight();
+    spectated.Stream();
+    late.Decode(spectated.bytes);
+    REQUIRE(late.State() == spectated.decoder.State());
+  }
+}
+
+TEST_CASE("malformed spectator stream") {
+  DeltaDecoder decoder;
+  const std::vector<uint8_t> pose{0x20, 1, 0};
+  REQUIRE_THROWS(decoder.Decode(pose));  // before any keyframe
+
+  Spectated spectated(5);
+  spectated.Stream();
+  std::vector<uint8_t> keyframe = spectated.bytes;
+  keyframe.pop_back();
+  REQUIRE_THROWS(decoder.Decode(keyframe));
+
+  decoder.Decode(spectated.bytes);
+  REQUIRE_THROWS(decoder.Decode(std::vector<uint8_t>{0xF0}));
+  REQUIRE_THROWS(decoder.Decode(std::vector<uint8_t>{0x3F, 0}));  // unknown type
+}
@@ -80,26 +80,67 @@ TEST_CASE("tetrimininos is composed of blocks") {
 }
 
 TEST_CASE("tetrimininos blocks can rotate") {
+  // super rotation system: I turns around the center of its 4x4 box
   tetris::Tetriminos t{tetris::Tetriminos::eType::I};
 
   t.Rotate();
   auto blocks = t.BlocksPosition();
-  REQUIRE(blocks.at(0) == tetris::Pos{0, 0});
-  REQUIRE(blocks.at(1) == tetris::Pos{0, 1});
-  REQUIRE(blocks.at(2) == tetris::Pos{0, 2});
-  REQUIRE(blocks.at(3) == tetris::Pos{0, 3});
+  REQUIRE(t.Rotation() == 1);
+  REQUIRE(blocks.at(0) == tetris::Pos{2, -1});
+  REQUIRE(blocks.at(1) == tetris::Pos{2, 0});
+  REQUIRE(blocks.at(2) == tetris::Pos{2, 1});
+  REQUIRE(blocks.at(3) == tetris::Pos{2, 2});
 
   t.Rotate();
   blocks = t.BlocksPosition();
-  REQUIRE(blocks.at(1) == tetris::Pos{-1, 0});
+  REQUIRE(blocks.at(1) == tetris::Pos{1, 1});
 
   t.Rotate();
   blocks = t.BlocksPosition();
-  REQUIRE(blocks.at(1) == tetris::Pos{0, -1});
+  REQUIRE(blocks.at(1) == tetris::Pos{1, 0});
 
   t.Rotate();
   blocks = t.BlocksPosition();
+  REQUIRE(t.Rotation() == 0);
   REQUIRE(blocks.at(1) == tetris::Pos{1, 0});
+
+  SECTION("and rotate back") {
+    t.RotateBack();
+    REQUIRE(t.Rotation() == 3);
+    REQUIRE(t.BlocksPosition().at(0) == tetris::Pos{1, -1});
+  }
+}
+
+TEST_CASE("tetrimininos turn around their center") {
+  using namespace tetris;
+  Tetriminos t{Tetriminos::eType::T};
+  t.Rotate();
+  auto blocks = t.BlocksPosition();
+  REQUIRE(std::find(blocks.begin(), blocks.end(), Pos{1, 0}) != blocks.end());  // nub on the right
+  REQUIRE(std::find(blocks.begin(), blocks.end(), Pos{0, 0}) != blocks.end());
+
+  Tetriminos o{Tetriminos::eType::O};
+  o.Rotate();
+  REQUIRE(o.BlocksPosition() == Tetriminos{Tetriminos::eType::O}.BlocksPosition());
+}
+
+TEST_CASE("rotation kicks") {
+  using namespace tetris;
+  using ty = Tetriminos::eType;
+
+  for (auto type : {ty::I, ty::O, ty::T, ty::L, ty::J, ty::Z, ty::S}) {
+    for (int from = 0; from < Tetriminos::kRotationCount; from++) {
+      INFO(type << " from " << from);
+      REQUIRE(Tetriminos::RotationKicks(type, from, true).front() == Pos{0, 0});
+      REQUIRE(Tetriminos::RotationKicks(type, from, false).front() == Pos{0, 0});
+    }
+  }
+
+  // wiki tables with y axis going down
+  REQUIRE(Tetriminos::RotationKicks(ty::T, 0, true).at(2) == Pos{-1, -1});
+  REQUIRE(Tetriminos::RotationKicks(ty::Z, 3, false).at(4) == Pos{-1, -2});
+  REQUIRE(Tetriminos::RotationKicks(ty::I, 0, true).at(4) == Pos{1, -2});
+  REQUIRE(Tetriminos::RotationKicks(ty::I, 2, false).at(3) == Pos{1, 2});
 }
 
 TEST_CASE("tetriminos can  move down left and right") {
@@ -131,4 +172,45 @@ TEST_CASE("can detect collision between blocks") {
   REQUIRE(tetris::Collision(not_a, a) == false);
   REQUIRE(tetris::Collision(intersect_a, a) == true);
   REQUIRE(tetris::Collision(a, intersect_a) == true);
-}
\ No newline at end of file
+}
+TEST_CASE("tetriminos bounds follow rotation") {
+  using namespace tetris;
+  auto type = GENERATE(Tetriminos::eType::I, Tetriminos::eType::O, Tetriminos::eType::T,
+                       Tetriminos::eType::L, Tetriminos::eType::J, Tetriminos::eType::Z,
+                       Tetriminos::eType::S);
+  Tetriminos t{type};
+
+  for (int rotation = 0; rotation < 4; rotation++) {
+    const auto& blocks = t.BlocksPosition();
+    auto [min_x, max_x] = std::minmax_element(blocks.begin(), blocks.end(),
+                                              [](Pos a, Pos b) { return a.x < b.x; });
+    auto [min_y, max_y] = std::minmax_element(blocks.begin(), blocks.end(),
+                                              [](Pos a, Pos b) { return a.y < b.y; });
+    INFO(type << " rotation " << rotation);
+    REQUIRE(t.BlocksBounds().left == min_x->x);
+    REQUIRE(t.BlocksBounds().right == max_x->x);
+    REQUIRE(t.BlocksBounds().top == min_y->y);
+    REQUIRE(t.BlocksBounds().bottom == max_y->y);
+    t.Rotate();
+  }
+}
+
+TEST_CASE("tetriminos factory keeps its preview in a ring") {
+  using namespace tetris;
+  struct Cycle final : ITetriminosGenerator {
+    int next{};
+    Tetriminos Create() override {
+      return Tetriminos{static_cast<Tetriminos::eType>(next++ % Tetriminos::BlockTypeCount())};
+    }
+  };
+
+  Cycle gen;
+  BasicTetriminosFactory<Cycle> factory(gen, 3);
+  for (int i = 0; i < 10; i++) {
+    INFO("take " << i);
+    REQUIRE(factory.Next(2).Type() == static_cast<Tetriminos::eType>((i + 2) % 7));
+    REQUIRE(factory.Take().Type() == static_cast<Tetriminos::eType>(i % 7));
+  }
+  REQUIRE_THROWS_AS(factory.Next(3), std::runtime_error);
+  REQUIRE_THROWS_AS(BasicTetriminosFactory<Cycle>(gen, 0), std::runtime_error);
+}
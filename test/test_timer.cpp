@@ -1,6 +1,10 @@
 
 #include <Tetris/PollingTimer.h>
+#include <Tetris/TimerWheel.h>
+#include <Tetris/VirtualTimer.h>
 #include <catch2/catch.hpp>
+#include <memory>
+#include <random>
 using namespace tetris;
 using namespace std::literals::chrono_literals;
 
@@ -22,4 +26,197 @@ TEST_CASE("polling timer") {
   REQUIRE(timer.Poll() == true);
 
   REQUIRE(mock.call == 1);
-}
\ No newline at end of file
+}
+TEST_CASE("virtual timer") {
+  VirtualTimer timer;
+  TimerMock mock;
+  timer.Register(&mock);
+
+  REQUIRE(timer.Advance(10s) == 0);  // not started
+  REQUIRE(timer.AdvanceToNextEvent() == false);
+  REQUIRE(timer.Now() == 10s);
+
+  timer.Start(100ms);
+  REQUIRE(timer.TimeToNextEvent() == 100ms);
+
+  SECTION("fires as many events as the elapsed time warrants") {
+    REQUIRE(timer.Advance(99ms) == 0);
+    REQUIRE(timer.Advance(1ms) == 1);
+    REQUIRE(timer.Advance(1050ms) == 10);
+    REQUIRE(timer.TimeToNextEvent() == 50ms);
+    REQUIRE(timer.Advance(16667us) == 0);
+    REQUIRE(mock.call == 11);
+  }
+
+  SECTION("jumps to the next event") {
+    timer.Advance(30ms);
+    REQUIRE(timer.AdvanceToNextEvent());
+    REQUIRE(timer.Now() == 10s + 100ms);
+    REQUIRE(mock.call == 1);
+  }
+
+  SECTION("time goes on while stopped") {
+    timer.Stop();
+    REQUIRE(timer.Advance(1s) == 0);
+    timer.Start(100ms);
+    REQUIRE(timer.Advance(100ms) == 1);
+  }
+
+  SECTION("period must be positive") { REQUIRE_THROWS(timer.Start(0ms)); }
+}
+
+TEST_CASE("virtual timer can be restarted by its listener") {
+  struct Restarter : TimerListener {
+    VirtualTimer& timer;
+    explicit Restarter(VirtualTimer& t) : timer(t) {}
+    void OnTimerEvent(const ITimer&) override {
+      call++;
+      if (call == 2)
+        timer.Start(10ms);
+      if (call == 5)
+        timer.Stop();
+    }
+    int call{};
+  };
+
+  VirtualTimer timer;
+  Restarter listener{timer};
+  timer.Register(&listener);
+  timer.Start(100ms);
+
+  REQUIRE(timer.Advance(1s) == 5);  // 100, 200, then every 10ms
+  REQUIRE(timer.Now() == 1s);
+  REQUIRE(timer.IsStarted() == false);
+}
+
+TEST_CASE("timer wheel") {
+  TimerWheel wheel;
+  std::vector<std::pair<int, int64_t>> fired;  // timer, time
+  struct Recorder : TimerListener {
+    Recorder(TimerWheel& w, std::vector<std::pair<int, int64_t>>& f, int i)
+        : wheel(w), fired(f), id(i) {}
+    void OnTimerEvent(const ITimer&) override { fired.emplace_back(id, wheel.Now().count()); }
+    TimerWheel& wheel;
+    std::vector<std::pair<int, int64_t>>& fired;
+    int id;
+  };
+  WheelTimer a(wheel), b(wheel);
+  Recorder ra(wheel, fired, 0), rb(wheel, fired, 1);
+  a.Register(&ra);
+  b.Register(&rb);
+
+  SECTION("fires timers at their deadlines, in order") {
+    a.Start(30ms);
+    b.Start(20ms);
+    REQUIRE(wheel.AdvanceTo(65ms) == 5);
+    REQUIRE(fired ==
+            std::vector<std::pair<int, int64_t>>{{1, 20}, {0, 30}, {1, 40}, {0, 60}, {1, 60}});
+  }
+
+  SECTION("long periods move down the levels") {
+    const std::chrono::milliseconds period{TimerWheel::kSlots * TimerWheel::kSlots + 5};
+    a.Start(period);
+    REQUIRE(wheel.AdvanceTo(period - 1ms) == 0);
+    REQUIRE(wheel.AdvanceTo(period) == 1);
+    REQUIRE(fired.back().second == period.count());
+  }
+
+  SECTION("periods longer than the wheel wait at the top level") {
+    const std::chrono::milliseconds period{TimerWheel::kRange + 3};
+    a.Start(period);
+    REQUIRE(wheel.AdvanceTo(period - 1ms) == 0);
+    REQUIRE(wheel.AdvanceTo(period) == 1);
+    REQUIRE(wheel.AdvanceTo(2 * period) == 1);
+  }
+
+  SECTION("tells when the next timer may fire") {
+    REQUIRE(wheel.TimeToNextEvent() == std::chrono::milliseconds::max());
+    a.Start(10ms);
+    REQUIRE(wheel.TimeToNextEvent() == 10ms);
+    wheel.AdvanceTo(15ms);
+    REQUIRE(wheel.TimeToNextEvent() == 5ms);
+    a.Start(1s);
+    REQUIRE(wheel.TimeToNextEvent() <= 1s);
+    REQUIRE(wheel.Size() == 1);
+  }
+
+  SECTION("stopped timers do not fire") {
+    a.Start(10ms);
+    b.Start(10ms);
+    a.Stop();
+    REQUIRE(wheel.AdvanceTo(100ms) == 10);
+    REQUIRE(a.IsStarted() == false);
+  }
+
+  SECTION("restart changes the period from now") {
+    a.Start(100ms);
+    wheel.AdvanceTo(50ms);
+    a.Start(10ms);
+    wheel.AdvanceTo(70ms);
+    REQUIRE(fired == std::vector<std::pair<int, int64_t>>{{0, 60}, {0, 70}});
+  }
+
+  SECTION("period must be positive") { REQUIRE_THROWS(a.Start(0ms)); }
+}
+
+TEST_CASE("wheel timers can be restarted by their listener") {
+  struct Restarter : TimerListener {
+    WheelTimer& timer;
+    explicit Restarter(WheelTimer& t) : timer(t) {}
+    void OnTimerEvent(const ITimer&) override {
+      call++;
+      if (call == 2)
+        timer.Start(10ms);
+      if (call == 5)
+        timer.Stop();
+    }
+    int call{};
+  };
+
+  TimerWheel wheel;
+  WheelTimer timer(wheel);
+  Restarter listener{timer};
+  timer.Register(&listener);
+  timer.Start(100ms);
+
+  REQUIRE(wheel.AdvanceTo(1s) == 5);  // 100, 200, then every 10ms
+  REQUIRE(timer.IsStarted() == false);
+}
+
+TEST_CASE("timer wheel fires many timers like their own timers would") {
+  struct Checker : TimerListener {
+    void OnTimerEvent(const ITimer& t) override {
+      const auto& timer = static_cast<const WheelTimer&>(t);
+      call++;
+      late += (wheel->Now() - start) % timer.Period() != 0ms;
+    }
+    TimerWheel* wheel;
+    std::chrono::milliseconds start;
+    int call{};
+    int late{};
+  };
+
+  TimerWheel wheel;
+  std::mt19937 rng{7};
+  std::vector<std::unique_ptr<WheelTimer>> timers;
+  std::vector<Checker> checkers(1000);
+  for (auto& checker : checkers) {
+    checker.wheel = &wheel;
+    checker.start = wheel.Now();
+    timers.push_back(std::make_unique<WheelTimer>(wheel));
+    timers.back()->Register(&checker);
+    timers.back()->Start(std::chrono::milliseconds{1 + rng() % 5000});
+  }
+  REQUIRE(wheel.Size() == 1000);
+
+  std::chrono::milliseconds now{};
+  while (now < 20s) {
+    now += std::chrono::milliseconds{rng() % 300};
+    wheel.AdvanceTo(now);
+  }
+
+  for (size_t i = 0; i < timers.size(); i++) {
+    REQUIRE(checkers[i].call == now / timers[i]->Period());
+    REQUIRE(checkers[i].late == 0);
+  }
+}
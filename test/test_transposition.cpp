@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+
+#include <Tetris/TranspositionTable.h>
+#include <thread>
+#include <vector>
+
+using namespace tetris;
+
+namespace {
+
+using Entry = TranspositionTable::Entry;
+using eBound = TranspositionTable::eBound;
+
+//! entry derived from @param key, a torn entry would not match it
+Entry EntryOf(uint64_t key, uint8_t depth) {
+  return Entry{static_cast<int32_t>(key >> 20), static_cast<uint16_t>(key >> 7), depth,
+               eBound::Exact};
+}
+
+}  // namespace
+
+TEST_CASE("transposition table") {
+  TranspositionTable table(1000);
+  REQUIRE(table.Capacity() == 512);
+  REQUIRE_THROWS(TranspositionTable(3));
+
+  Entry entry;
+  REQUIRE(table.Probe(42, entry) == false);
+  table.Store(42, Entry{-7, 3, 5, eBound::Lower});
+  REQUIRE(table.Probe(42, entry));
+  REQUIRE(entry.value == -7);
+  REQUIRE(entry.move == 3);
+  REQUIRE(entry.depth == 5);
+  REQUIRE(entry.bound == eBound::Lower);
+  REQUIRE(table.Usage() == 1);
+
+  SECTION("same key is replaced") {
+    table.Store(42, Entry{9, 1, 2, eBound::Upper});
+    REQUIRE(table.Probe(42, entry));
+    REQUIRE(entry.value == 9);
+  }
+
+  SECTION("a full bucket drops its shallowest entry") {
+    const uint64_t bucket_stride = table.Capacity() / TranspositionTable::kBucketSize;
+    for (uint64_t i = 1; i < 4; i++)
+      table.Store(42 + i * bucket_stride, EntryOf(42 + i * bucket_stride, 10));
+    table.Store(42 + 4 * bucket_stride, EntryOf(0, 10));
+    REQUIRE(table.Probe(42, entry) == false);
+    for (uint64_t i = 1; i <= 4; i++)
+      REQUIRE(table.Probe(42 + i * bucket_stride, entry));
+  }
+
+  SECTION("entries of older searches are dropped first") {
+    const uint64_t bucket_stride = table.Capacity() / TranspositionTable::kBucketSize;
+    table.NewSearch();
+    REQUIRE(table.Usage() == 0);
+    for (uint64_t i = 1; i < 4; i++)
+      table.Store(42 + i * bucket_stride, EntryOf(0, 1));
+    table.Store(42 + 4 * bucket_stride, EntryOf(0, 1));
+    REQUIRE(table.Probe(42, entry) == false);  // deepest but oldest
+  }
+
+  SECTION("age comes before depth") {
+    const uint64_t bucket_stride = table.Capacity() / TranspositionTable::kBucketSize;
+    for (uint64_t i = 1; i < 4; i++)
+      table.Store(42 + i * bucket_stride, EntryOf(0, 200));
+    table.NewSearch();
+    table.Store(42 + 4 * bucket_stride, EntryOf(0, 0));
+    table.Store(42 + 5 * bucket_stride, EntryOf(0, 0));
+    REQUIRE(table.Probe(42 + 4 * bucket_stride, entry));  // shallow but current
+    REQUIRE(table.Probe(42 + 5 * bucket_stride, entry));
+  }
+
+  SECTION("clear") {
+    table.Clear();
+    REQUIRE(table.Probe(42, entry) == false);
+  }
+}
+
+TEST_CASE("transposition table usage is a permille of small tables too") {
+  TranspositionTable table(8);
+  REQUIRE(table.Capacity() == 8);
+  for (uint64_t key = 1; key <= 4; key++)
+    table.Store(key * 2, EntryOf(key, 1));  // one bucket of two
+  REQUIRE(table.Usage() == 500);
+}
+
+TEST_CASE("transposition table shared by threads") {
+  TranspositionTable table(1 << 12);
+  std::vector<std::thread> threads;
+  std::vector<int> torn(4), hits(4);
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&table, &torn, &hits, t] {
+      uint64_t key = 0x9e3779b97f4a7c15ull * (t + 1);
+      for (int i = 0; i < 200000; i++) {
+        key = key * 6364136223846793005ull + 1442695040888963407ull;
+        const uint64_t probed = key >> 50;  // few keys, all threads meet on them
+        Entry entry;
+        if (table.Probe(probed, entry)) {
+          hits[t]++;
+          const Entry expected = EntryOf(probed, entry.depth);
+          torn[t] += entry.value != expected.value || entry.move != expected.move;
+        }
+        table.Store(probed, EntryOf(probed, static_cast<uint8_t>(i)));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  for (int t = 0; t < 4; t++) {
+    REQUIRE(torn[t] == 0);
+    REQUIRE(hits[t] > 0);
+  }
+}
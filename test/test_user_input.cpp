@@ -9,13 +9,17 @@ struct TestableInputListener : InputListener {
   int on_left_call{};
   int on_right_call{};
   int on_rotate_call{};
+  int on_reverse_rotate_call{};
   int on_down_call{};
+  int on_hard_drop_call{};
   int on_pause_call{};
   int on_resume_call{};
   void OnLeft() override { on_left_call++; }
   void OnRight() override { on_right_call++; }
   void OnRotate() override { on_rotate_call++; }
+  void OnReverseRotate() override { on_reverse_rotate_call++; }
   void OnFastDown() override { on_down_call++; }
+  void OnHardDrop() override { on_hard_drop_call++; }
   void OnPause() override { on_pause_call++; }
   void OnResume() override { on_resume_call++; }
 };
@@ -25,7 +29,9 @@ TEST_CASE("keyboard implementation work is minimal") {
                              .AssignLeft('s')
                              .AssignRight('d')
                              .AssignRotate('r')
+                             .AssignReverseRotate('e')
                              .AssignMoveDown('w')
+                             .AssignHardDrop('h')
                              .AssignPause('p')
                              .AssignResume('x')
                              .Build();
@@ -43,6 +49,9 @@ TEST_CASE("keyboard implementation work is minimal") {
   input.OnKeyPressed('r');
   REQUIRE(listener.on_rotate_call == 1);
 
+  input.OnKeyPressed('e');
+  REQUIRE(listener.on_reverse_rotate_call == 1);
+
   input.OnKeyPressed('p');
   REQUIRE(listener.on_pause_call == 1);
 
@@ -52,6 +61,9 @@ TEST_CASE("keyboard implementation work is minimal") {
   input.OnKeyPressed('w');
   REQUIRE(listener.on_down_call == 1);
 
+  input.OnKeyPressed('h');
+  REQUIRE(listener.on_hard_drop_call == 1);
+
   SECTION("throw exception if user key is not assigned") {
     REQUIRE_THROWS_AS(input.OnKeyPressed("not assigned user input"), std::runtime_error);
   }